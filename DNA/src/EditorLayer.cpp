@@ -147,11 +147,11 @@ void EditorLayer::OnUpdate(SGE::TimeStep ts)
       glm::vec3 rayDir = cameraController->MouseToWorldCoordinates();
       auto ray = flg::Ray(
           camera.GetComponent<SGE::TransformComponent>().Position, rayDir);
-      auto hit = flg::PhysicsWorld::Raycast(&ray, 10000);
+      auto hit = m_Scene->GetPhysicsWorld().Raycast(&ray, 10000);
       if (hit.DidHit())
       {
         glm::vec3 colPoint = hit.CollisionPoint;
-        SGE::Entity hitEntity = {hit.body->GetEntityOwnerID(), m_Scene.get()};
+        SGE::Entity hitEntity = {hit.EntityOwnerID, m_Scene.get()};
 
         printf("Hit: %s\n",
                hitEntity.GetComponent<SGE::TagComponent>().Tag.c_str());
@@ -321,6 +321,11 @@ void EditorLayer::OnImGuiRender()
                                          .GetComponent<SGE::TagComponent>()
                                          .Tag.c_str());
 
+  // Script instances per type, peak is the most alive at once
+  for (const SGE::ScriptPoolStats *pool : SGE::ScriptPools::GetStats())
+    ImGui::Text("Scripts %.*s: %u live, %u peak, %u slots", static_cast<int>(pool->Name.size()), pool->Name.data(),
+                pool->Live, pool->Peak, pool->Capacity);
+
   ImGui::End();
 }
 
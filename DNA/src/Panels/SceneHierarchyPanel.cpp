@@ -218,7 +218,7 @@ namespace SGE
 				auto &rb = m_SelectedEntity.GetComponent<RigidBodyComponent>();
 
 				// TODO: Add body types to 3d Rigidbodies
-				switch (rb.Body.Type)
+				switch (rb.Body.GetType())
 				{
 				case flg::BodyType::Static:
 					ImGui::Text("Static");
@@ -234,22 +234,28 @@ namespace SGE
 					break;
 				};
 
-				if (ImGui::RadioButton("Static", rb.Body.Type == flg::BodyType::Static))
+				if (ImGui::RadioButton("Static", rb.Body.GetType() == flg::BodyType::Static))
 				{
-					rb.Body.Type = flg::BodyType::Static;
+					rb.Body.SetType(flg::BodyType::Static);
 				}
 				ImGui::SameLine();
-				if (ImGui::RadioButton("Dynamic", rb.Body.Type == flg::BodyType::Dynamic))
+				if (ImGui::RadioButton("Dynamic", rb.Body.GetType() == flg::BodyType::Dynamic))
 				{
-					rb.Body.Type = flg::BodyType::Dynamic;
+					rb.Body.SetType(flg::BodyType::Dynamic);
 				}
 				ImGui::SameLine();
-				if (ImGui::RadioButton("Kinematic", rb.Body.Type == flg::BodyType::Kinematic))
+				if (ImGui::RadioButton("Kinematic", rb.Body.GetType() == flg::BodyType::Kinematic))
 				{
-					rb.Body.Type = flg::BodyType::Kinematic;
+					rb.Body.SetType(flg::BodyType::Kinematic);
 				}
 				ImGui::SameLine();
 				ImGui::Checkbox("UseGravity", &rb.UseGravity);
+
+				flg::CollisionFilter filter = rb.Body.GetCollisionFilter();
+				bool filterChanged = ImGui::InputScalar("Category", ImGuiDataType_U32, &filter.Category, nullptr, nullptr, "%08X", ImGuiInputTextFlags_CharsHexadecimal);
+				filterChanged |= ImGui::InputScalar("Mask", ImGuiDataType_U32, &filter.Mask, nullptr, nullptr, "%08X", ImGuiInputTextFlags_CharsHexadecimal);
+				if (filterChanged)
+					rb.Body.SetCollisionFilter(filter);
 			}
 		}
 
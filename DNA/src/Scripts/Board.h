@@ -6,6 +6,7 @@
 #include "SGE/SGE.h"
 
 #include "GrassRenderer/GrassRenderer.h"
+#include "Layers.h"
 #include "Scene/Components.h"
 #include "Unit.h"
 #include <random>
@@ -28,9 +29,11 @@ public:
     checkerboardMaterial->SpecularColor = glm::vec3(1.0f);
     meshRenderer.Model->SetMaterial(checkerboardMaterial);
 
+    // Ground contact comes from the physics world floor, which raycasts do not see. The plane body is kept for ground
+    // picks, its empty mask leaves it out of every pair.
     plane.GetComponent<SGE::TransformComponent>().Scale = {100.0f, 0.0, 100.0f};
-    plane.AddComponent<SGE::RigidBodyComponent>().Body.BodyTransform.Position = plane.GetComponent<SGE::TransformComponent>().Position;
-    plane.AddComponent<SGE::PlaneColliderComponent>();
+    plane.AddComponent<SGE::RigidBodyComponent>().SetCollisionFilter(GroundLayer, 0);
+    plane.AddComponent<SGE::PlaneColliderComponent>().planeCollider.Bounds = {100.0f, 100.0f};
 
     // Spawn Grass
     glm::vec2 grassDim = {300.0f, 300.0f};
@@ -55,25 +58,37 @@ public:
 
     SGE::Model::CreateModel("./assets/models/apple/Apple.fbx", true);
 
-    // Spawn Units
+    // Spawn Units, one batch from the unit prefab
     glm::vec2 boardDim = {2.0f, 2.0f};
     float unitSpacing = 5.0f;
 
+    SGE::Ref<SGE::Prefab> unitPrefab = SGE::Prefab::CreatePrefab("Unit");
+    unitPrefab->AddNativeScriptComponent<Unit>();
+    unitPrefab->AddComponent<SGE::MeshRendererComponent>(SGE::Model::CreateModel("assets/models/slime/slime.fbx", true));
+    auto &rb = unitPrefab->AddComponent<SGE::RigidBodyComponent>();
+    rb.Body.SetType(flg::BodyType::Dynamic);
+    rb.SetCollisionFilter(UnitLayer, UnitLayer | FoodLayer);
+    unitPrefab->AddComponent<SGE::SphereColliderComponent>().sphereCollider.Radius = 1.0f;
+    unitPrefab->GetTransform().Scale = glm::vec3(0.02f);
+
+    std::vector<SGE::TransformComponent> transforms;
     for (uint32_t i = 0; i < boardDim.x; i++)
     {
       for (uint32_t j = 0; j < boardDim.y; j++)
       {
-        std::stringstream s;
-        s << "Unit_" << i << '_' << j;
-
-        SGE::Entity e = GameObject().GetSceneHandle()->CreateEntity(s.str(), glm::vec3(i * unitSpacing, 0.4f, j * unitSpacing));
-        e.AddNativeScriptComponent<Unit>();
-        e.AddComponent<SGE::MeshRendererComponent>(SGE::Model::CreateModel("assets/models/slime/slime.fbx", true));
-        e.AddComponent<SGE::RigidBodyComponent>().Body.Type = flg::BodyType::Dynamic;
-        e.AddComponent<SGE::SphereColliderComponent>().sphereCollider.Radius = 1.0f;
-        e.GetComponent<SGE::TransformComponent>().Scale *= 0.02f;
+        SGE::TransformComponent transform = unitPrefab->GetTransform();
+        transform.Position = glm::vec3(i * unitSpacing, 0.4f, j * unitSpacing);
+        transforms.push_back(transform);
       }
     }
+
+    std::vector<SGE::Entity> units = GameObject().GetSceneHandle()->Instantiate(*unitPrefab, static_cast<uint32_t>(transforms.size()), transforms);
+    for (uint32_t i = 0; i < units.size(); i++)
+    {
+      std::stringstream s;
+      s << "Unit_" << i / static_cast<uint32_t>(boardDim.y) << '_' << i % static_cast<uint32_t>(boardDim.y);
+      units[i].GetComponent<SGE::TagComponent>().Tag = s.str();
+    }
   }
 
   virtual void OnStart() override
@@ -82,18 +97,20 @@ public:
     m_Selected.resize(MAX_SELECTED_UNITS);
 
     // Spawn Food
-    for (int32_t i = 0; i < 10.0f; i++)
-    {
-      SGE::Entity e = GameObject().GetSceneHandle()->CreateEntity("Food");
-      e.AddNativeScriptComponent<Food>();
-      e.AddComponent<SGE::MeshRendererComponent>(SGE::ResourceManager::GetModel("./assets/models/apple/Apple.fbx"));
-      e.AddComponent<SGE::RigidBodyComponent>();
-      e.AddComponent<SGE::SphereColliderComponent>();
-      e.GetComponent<SGE::TransformComponent>().Scale *= 0.1f;
-    }
+    SGE::Ref<SGE::Prefab> foodPrefab = SGE::Prefab::CreatePrefab("Food");
+    foodPrefab->AddNativeScriptComponent<Food>();
+    foodPrefab->AddComponent<SGE::MeshRendererComponent>(SGE::ResourceManager::GetModel("./assets/models/apple/Apple.fbx"));
+    foodPrefab->AddComponent<SGE::RigidBodyComponent>().SetCollisionFilter(FoodLayer, UnitLayer);
+    foodPrefab->AddComponent<SGE::SphereColliderComponent>();
+    foodPrefab->GetTransform().Scale = glm::vec3(0.1f);
+    GameObject().GetSceneHandle()->Instantiate(*foodPrefab, 10);
   }
 
-  virtual void OnUpdate(SGE::TimeStep timeStep) { ProcessInput(); }
+  virtual void OnUpdate(SGE::TimeStep timeStep)
+  {
+    ProcessInput();
+    ProcessMoveOrder();
+  }
 
   void ProcessInput()
   {
@@ -109,13 +126,14 @@ public:
       auto ray = flg::Ray(
           camera.GetComponent<SGE::TransformComponent>().Position, rayDir);
 
-      auto hit = flg::PhysicsWorld::Raycast(&ray, 10000);
+      // Only units can be selected
+      auto hit = GameObject().GetSceneHandle()->GetPhysicsWorld().Raycast(&ray, 10000, UnitLayer);
       if (hit.DidHit())
       {
         DeselectAll();
 
         glm::vec3 colPoint = hit.CollisionPoint;
-        SGE::Entity hitEntity = {hit.body->GetEntityOwnerID(),
+        SGE::Entity hitEntity = {hit.EntityOwnerID,
                                  GameObject().GetSceneHandle()};
 
         printf("Hit: %s\n",
@@ -143,6 +161,29 @@ public:
     }
   }
 
+  // Move orders for the selected units, which update on the job threads where input cannot be read
+  void ProcessMoveOrder()
+  {
+    if (m_SelectCount == 0 || !SGE::Input::IsMouseButtonPressed(GLFW_MOUSE_BUTTON_2))
+      return;
+
+    SGE::Entity camera = SGE::Renderer::GetSceneData().MainCamera;
+    CameraController *cameraController = camera.GetNativeScriptComponent<CameraController>();
+    if (!cameraController)
+      return;
+
+    glm::vec3 rayDir = cameraController->MouseToWorldCoordinates();
+    auto ray = flg::Ray(camera.GetComponent<SGE::TransformComponent>().Position, rayDir);
+
+    // Targets are points on the ground plane, see OnCreate
+    auto hit = GameObject().GetSceneHandle()->GetPhysicsWorld().Raycast(&ray, 1000, GroundLayer);
+    if (!hit.DidHit())
+      return;
+
+    for (uint32_t i = 0; i < m_SelectCount; i++)
+      m_Selected[i]->MoveTo(hit.CollisionPoint);
+  }
+
   void DeselectAll()
   {
     for (uint32_t i = 0; i < m_SelectCount; i++)
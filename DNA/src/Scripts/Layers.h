@@ -0,0 +1,17 @@
+#ifndef LAYERS_H
+#define LAYERS_H
+
+#pragma once
+
+#include <cstdint>
+
+// Collision categories of the board's bodies. Food only has to be tested against units.
+// The ground collides with nothing, it is only there for raycasts that ask for it by mask.
+enum Layer : uint32_t
+{
+    UnitLayer = 1 << 0,
+    FoodLayer = 1 << 1,
+    GroundLayer = 1 << 2,
+};
+
+#endif
@@ -11,9 +11,25 @@
 
 #include "Food.h"
 
+// What a unit does next, queued by the unit itself and run on its next action tick
+struct UnitAction
+{
+    enum class Type : uint8_t
+    {
+        Search,         // Wander to a nearby point
+        ExtendedSearch, // Levy flight jump to a point further out
+        Breed           // Spawn a baby next to the unit
+    };
+
+    Type Kind = Type::Search;
+};
+
 class Unit : public SGE::ScriptableEntity
 {
 public:
+    // Hundreds of units, so they update across the job threads. Body writes and spawns go through Scene::Defer.
+    static constexpr SGE::ScriptAccess UpdateAccess = SGE::ScriptAccess::OwnEntity;
+
     virtual void OnUpdate(SGE::TimeStep timestep) override
     {
         if (m_IsDead)
@@ -30,11 +46,10 @@ public:
         {
             if (m_ActionTime >= m_ActionDelay)
             {
-                if (!m_UnitActionQueue.empty())
+                UnitAction action;
+                if (m_UnitActionQueue.Pop(action))
                 {
-                    auto &action = m_UnitActionQueue.front();
-                    action();
-                    m_UnitActionQueue.pop();
+                    RunAction(action);
                 }
                 else if (!m_IsSelected)
                 {
@@ -46,12 +61,13 @@ public:
                 m_ActionTime = 0.0f;
             }
 
-            ProcessInput();
             ProcessGoTo(timestep);
         }
         else
         {
-            if (GameObject().GetComponent<SGE::TransformComponent>().Position.y <= 1.4f)
+            // Back on the world floor
+            float groundHeight = GameObject().GetSceneHandle()->GetPhysicsWorld().GetProperties().WorldFloorHeight + GameObject().GetComponent<SGE::SphereColliderComponent>().sphereCollider.Radius;
+            if (GameObject().GetComponent<SGE::TransformComponent>().Position.y <= groundHeight)
                 m_IsDisabled = false;
         }
     };
@@ -90,6 +106,12 @@ public:
     virtual void Select() { m_IsSelected = true; }
     virtual void Deselect() { m_IsSelected = false; }
 
+    // Move order from the board, keeps the unit's height
+    void MoveTo(const glm::vec3 &point)
+    {
+        Goto({point.x, GameObject().GetComponent<SGE::TransformComponent>().Position.y, point.z});
+    }
+
 private:
     void Reset()
     {
@@ -101,7 +123,8 @@ private:
         m_Damage = 1.0f;
         m_IsDisabled = false;
 
-        // Reset General
+        // Reset General. OnStart runs on the main thread, Search draws from m_Random on the job threads.
+        m_Random.seed(static_cast<uint32_t>(rand()));
         m_Sex = rand() % 2;
         m_IsDead = false;
         m_IsSelected = false;
@@ -109,37 +132,8 @@ private:
         // Reset RigidBody to Kinematic for regular movement
         auto &rb = GameObject().GetComponent<SGE::RigidBodyComponent>();
         rb.Body.SetPosition(glm::vec3{(rand() - RAND_MAX / 2) % 10, 1.4f, (rand() - RAND_MAX / 2) % 10});
-        rb.Body.Type = flg::BodyType::Dynamic;
+        rb.Body.SetType(flg::BodyType::Dynamic);
     }
-    void ProcessInput()
-    {
-        if (!m_IsSelected)
-            return;
-
-        if (SGE::Input::IsMouseButtonPressed(GLFW_MOUSE_BUTTON_2))
-        {
-            SGE::Entity camera = SGE::Renderer::GetSceneData().MainCamera;
-            CameraController *cameraController = camera.GetNativeScriptComponent<CameraController>();
-            if (!cameraController)
-                return;
-
-            glm::vec3 rayDir = cameraController->MouseToWorldCoordinates();
-            auto ray = flg::Ray(
-                camera.GetComponent<SGE::TransformComponent>().Position, rayDir);
-
-            auto hit = flg::PhysicsWorld::Raycast(&ray, 1000);
-            if (hit.DidHit())
-            {
-                glm::vec3 colPoint = hit.CollisionPoint;
-                SGE::Entity hitEntity = {hit.body->GetEntityOwnerID(),
-                                         GameObject().GetSceneHandle()};
-                Goto({colPoint.x,
-                      GameObject().GetComponent<SGE::TransformComponent>().Position.y,
-                      colPoint.z});
-            }
-        }
-    }
-
     void ProcessGoTo(SGE::TimeStep timestep)
     {
         if (m_InTransit)
@@ -147,21 +141,26 @@ private:
             glm::vec3 direction = m_Destination - GameObject().GetComponent<SGE::TransformComponent>().Position;
             if (glm::length(direction) <= 2.0f)
             {
-                auto &rb = GameObject().GetComponent<SGE::RigidBodyComponent>();
-                rb.Body.Velocity = glm::vec3(0.0f);
-                rb.Body.Force = glm::vec3(0.0f);
+                GameObject().GetSceneHandle()->Defer([this]()
+                                                     {
+                    auto &rb = GameObject().GetComponent<SGE::RigidBodyComponent>();
+                    rb.Body.SetVelocity(glm::vec3(0.0f));
+                    rb.Body.SetForce(glm::vec3(0.0f)); });
                 m_InTransit = false;
             }
             else
             {
                 auto &rb = GameObject().GetComponent<SGE::RigidBodyComponent>();
                 glm::vec3 velocity = direction * m_MovementSpeed * 1000.0f * timestep.GetSeconds();
+                glm::vec3 bodyVelocity = rb.Body.GetVelocity();
 
                 if (glm::abs(velocity.x) > m_MovementSpeed)
-                    rb.Body.Velocity.x = m_MovementSpeed * (glm::sign(velocity.x));
+                    bodyVelocity.x = m_MovementSpeed * (glm::sign(velocity.x));
                 if (glm::abs(velocity.z) > m_MovementSpeed)
-                    rb.Body.Velocity.z = m_MovementSpeed * (glm::sign(velocity.z));
-                rb.Body.Velocity.y = 0;
+                    bodyVelocity.z = m_MovementSpeed * (glm::sign(velocity.z));
+                bodyVelocity.y = 0;
+                GameObject().GetSceneHandle()->Defer([this, bodyVelocity]()
+                                                     { GetComponent<SGE::RigidBodyComponent>().Body.SetVelocity(bodyVelocity); });
             }
         }
     }
@@ -174,7 +173,7 @@ private:
 
     void GenerateUnitAction()
     {
-        if (!(static_cast<uint32_t>(m_UnitActionQueue.size()) < maxActionsQueue))
+        if (m_UnitActionQueue.Size() >= maxActionsQueue)
             return;
 
         // Levy Pattern
@@ -182,22 +181,50 @@ private:
         if (m_LocalSearchMoves > 5)
         {
             m_LocalSearchMoves = 0;
-            m_UnitActionQueue.emplace([&]()
-                                      { 
-                                        auto& position = GameObject().GetComponent<SGE::TransformComponent>().Position;
-                                        glm::vec3 nextDestination = position + glm::vec3{(rand() - RAND_MAX/2) % m_ExtendedSearchRange , position.y, (rand() - RAND_MAX/2) % m_ExtendedSearchRange};
-                                        Goto(nextDestination); });
+            m_UnitActionQueue.Push({UnitAction::Type::ExtendedSearch});
         }
         else
         {
-            m_UnitActionQueue.emplace([&]()
-                                      { 
-                                        auto& position = GameObject().GetComponent<SGE::TransformComponent>().Position;
-                                        glm::vec3 nextDestination = position + glm::vec3{(rand() - RAND_MAX/2) % m_SearchRange, position.y, (rand() - RAND_MAX/2) % m_SearchRange};
-                                        Goto(nextDestination); });
+            m_UnitActionQueue.Push({UnitAction::Type::Search});
+        }
+    }
+
+    void RunAction(const UnitAction &action)
+    {
+        switch (action.Kind)
+        {
+        case UnitAction::Type::Search:
+            Search(m_SearchRange);
+            break;
+        case UnitAction::Type::ExtendedSearch:
+            Search(m_ExtendedSearchRange);
+            break;
+        case UnitAction::Type::Breed:
+            SpawnBaby();
+            break;
         }
     }
 
+    void Search(int range)
+    {
+        auto &position = GameObject().GetComponent<SGE::TransformComponent>().Position;
+        std::uniform_int_distribution<int> offset(1 - range, range - 1);
+        glm::vec3 nextDestination = position + glm::vec3{offset(m_Random), position.y, offset(m_Random)};
+        Goto(nextDestination);
+    }
+
+    // Runs from OnUpdate on a job thread, so the baby is recorded and spawned at the scene's next sync point
+    void SpawnBaby()
+    {
+        SGE::EntityCommandBuffer &commands = GameObject().GetSceneHandle()->Commands();
+        SGE::PendingEntity baby = commands.CreateEntity("Baby_" + std::to_string(static_cast<int>(m_BreadCount)));
+        commands.AddComponent<SGE::TransformComponent>(baby, GetComponent<SGE::TransformComponent>());
+        commands.AddComponent<SGE::MeshRendererComponent>(baby, GetComponent<SGE::MeshRendererComponent>().Model);
+        commands.AddComponent<SGE::RigidBodyComponent>(baby);
+        commands.AddComponent<SGE::SphereColliderComponent>(baby, GetComponent<SGE::SphereColliderComponent>());
+        commands.AddNativeScriptComponent<Unit>(baby);
+    }
+
     // [Unit Action]
     bool Battle(Unit *enemy)
     {
@@ -222,18 +249,14 @@ private:
     // [Unit Action]
     bool Breed(Unit *ally)
     {
-        if (!m_UnitActionQueue.size() < maxActionsQueue)
+        if (m_UnitActionQueue.Size() >= maxActionsQueue)
             return false;
 
         // Population Control
         if (m_BreadCount > 250)
             return false;
 
-        m_UnitActionQueue.emplace([&]()
-                                  {
-        SGE::Entity e = GameObject().GetSceneHandle()->CreateEntity(GameObject(), std::string("Baby_", m_BreadCount));
-        e.GetComponent<SGE::TransformComponent>().Position +(glm::vec3(10.0, 1.4f, 10.0) * m_BreadCount); 
-        e.AddNativeScriptComponent<Unit>(); });
+        m_UnitActionQueue.Push({UnitAction::Type::Breed});
 
         m_BreadCount++;
 
@@ -256,8 +279,13 @@ private:
         m_InTransit = false;
         m_IsDead = true;
 
-        GameObject().GetComponent<SGE::RigidBodyComponent>().Body.BodyTransform.Position.y = (100.0f);
-        GameObject().GetComponent<SGE::RigidBodyComponent>().Body.Type = flg::Static;
+        GameObject().GetSceneHandle()->Defer([this]()
+                                             {
+            auto &rb = GameObject().GetComponent<SGE::RigidBodyComponent>();
+            glm::vec3 position = rb.Body.GetPosition();
+            position.y = 100.0f;
+            rb.Body.SetPosition(position);
+            rb.Body.SetType(flg::Static); });
     }
 
     // [Check]
@@ -292,10 +320,11 @@ private:
     int m_SearchRange = 5;
     int m_ExtendedSearchRange = 25;
     int m_LocalSearchMoves = 0;
+    std::minstd_rand m_Random;
 
-    // Action Queue
-    std::queue<std::function<void()>> m_UnitActionQueue;
-    int maxActionsQueue = 1;
+    // Action Queue, maxActionsQueue caps how many of the ring's slots are used
+    SGE::ActionQueue<UnitAction, 4> m_UnitActionQueue;
+    uint32_t maxActionsQueue = 1;
 
     static float m_BreadCount;
 };
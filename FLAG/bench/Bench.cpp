@@ -0,0 +1,46 @@
+#include "Bench.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace flg
+{
+	namespace bench
+	{
+		struct Result
+		{
+			std::string Suite;
+			std::string Test;
+			uint64_t Size;
+			std::string Metric;
+			double Value;
+		};
+
+		static Options s_Options;
+		static std::vector<Result> s_Results;
+
+		Options &GetOptions()
+		{
+			return s_Options;
+		}
+
+		void Record(const std::string &suite, const std::string &test, uint64_t size, const std::string &metric, double value)
+		{
+			s_Results.push_back({suite, test, size, metric, value});
+		}
+
+		bool WriteResults(const std::string &path)
+		{
+			FILE *file = fopen(path.c_str(), "w");
+			if (!file)
+				return false;
+
+			fprintf(file, "suite,test,size,metric,value\n");
+			for (const Result &result : s_Results)
+				fprintf(file, "%s,%s,%llu,%s,%.6g\n", result.Suite.c_str(), result.Test.c_str(), static_cast<unsigned long long>(result.Size),
+						result.Metric.c_str(), result.Value);
+
+			return fclose(file) == 0;
+		}
+	}
+}
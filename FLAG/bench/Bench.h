@@ -0,0 +1,64 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include <glm/glm.hpp>
+
+namespace flg
+{
+    namespace bench
+    {
+        class Timer
+        {
+        public:
+            Timer() { Reset(); }
+
+            void Reset() { m_Start = std::chrono::high_resolution_clock::now(); }
+            double ElapsedSeconds() const
+            {
+                return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - m_Start).count();
+            }
+
+        private:
+            std::chrono::high_resolution_clock::time_point m_Start;
+        };
+
+        // Command line options shared by every suite, see main.cpp
+        struct Options
+        {
+            uint32_t Seed = 1337; // Every random scene is built from this seed, so runs with the same seed measure the same scenes
+            std::string CsvPath;  // Machine readable results are written here when set
+        };
+        Options &GetOptions();
+
+        // Adds a value to the machine readable results as a suite,test,size,metric,value line. Lines keep the order
+        // they were recorded in, so the results of two commits diff line by line.
+        void Record(const std::string &suite, const std::string &test, uint64_t size, const std::string &metric, double value);
+        bool WriteResults(const std::string &path);
+
+        // Uniform point inside a cube of half size extent
+        inline glm::vec3 RandomPoint(std::mt19937 &rng, float extent)
+        {
+            std::uniform_real_distribution<float> dist(-extent, extent);
+            return glm::vec3{dist(rng), dist(rng), dist(rng)};
+        }
+
+        // Benchmark Suites
+        void RunBroadphaseBenchmarks();
+        void RunNarrowphaseBenchmarks();
+        void RunStepBenchmarks();
+        void RunCallbackBenchmarks();
+        void RunQueryBenchmarks();
+        void RunSolverBenchmarks();
+        void RunContinuousBenchmarks();
+        void RunDeterminismChecks();
+    }
+}
+
+#endif
@@ -0,0 +1,145 @@
+#include "Bench.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Body.h"
+#include "Broadphase.h"
+#include "Collider.h"
+
+namespace flg
+{
+	namespace bench
+	{
+		static const char *BroadphaseName(BroadphaseType type)
+		{
+			switch (type)
+			{
+			case BroadphaseType::BruteForce:
+				return "BruteForce";
+			case BroadphaseType::SpatialHash:
+				return "SpatialHash";
+			case BroadphaseType::SweepAndPrune:
+				return "SweepAndPrune";
+			}
+			return "Unknown";
+		}
+
+		// Pairs that survive the narrowphase
+		static std::vector<BodyPair> NarrowPhase(const std::vector<SphereCollider> &spheres, const std::vector<Transform> &transforms, const std::vector<BodyPair> &pairs)
+		{
+			std::vector<BodyPair> contacts;
+			for (const BodyPair &pair : pairs)
+			{
+				if (spheres[pair.A].TestCollision(&transforms[pair.A], &spheres[pair.B], &transforms[pair.B]).DidCollide)
+					contacts.push_back(pair);
+			}
+			return contacts;
+		}
+
+		// Unit spheres spread over a cube with volume per body units^3 for each of them
+		static void BuildScene(uint32_t bodyCount, float volumePerBody, std::vector<SphereCollider> &spheres, std::vector<Transform> &transforms,
+							   std::vector<BroadphaseProxy> &proxies)
+		{
+			std::mt19937 rng(GetOptions().Seed);
+			float extent = 0.5f * glm::pow(volumePerBody * static_cast<float>(bodyCount), 1.0f / 3.0f);
+
+			spheres.assign(bodyCount, SphereCollider{glm::vec3{0.0f}, 1.0f});
+			transforms.assign(bodyCount, Transform{});
+			proxies.assign(bodyCount, BroadphaseProxy{});
+			for (uint32_t i = 0; i < bodyCount; i++)
+			{
+				transforms[i].Position = RandomPoint(rng, extent);
+
+				proxies[i].Collidable = true;
+				proxies[i].Bounded = spheres[i].ComputeAABB(&transforms[i], proxies[i].Bounds);
+			}
+		}
+
+		// One row per broadphase, checked against the brute force contacts where that is affordable
+		static void RunBroadphases(const char *scene, const std::vector<SphereCollider> &spheres, const std::vector<Transform> &transforms,
+								   const std::vector<BroadphaseProxy> &proxies)
+		{
+			const BroadphaseType types[] = {BroadphaseType::BruteForce, BroadphaseType::SpatialHash, BroadphaseType::SweepAndPrune};
+			const uint32_t bodyCount = static_cast<uint32_t>(proxies.size());
+
+			// Brute force above this is billions of tests per pass
+			const uint32_t maxBruteForceBodies = 10000;
+
+			std::vector<BodyPair> reference;
+			bool hasReference = false;
+			for (BroadphaseType type : types)
+			{
+				if (type == BroadphaseType::BruteForce && bodyCount > maxBruteForceBodies)
+					continue;
+
+				std::unique_ptr<Broadphase> broadphase = Broadphase::CreateBroadphase(type);
+				std::vector<BodyPair> pairs;
+
+				// Warm up allocations and the sweep and prune order
+				broadphase->FindPairs(proxies, pairs);
+
+				uint32_t passes = 0;
+				Timer timer;
+				do
+				{
+					broadphase->FindPairs(proxies, pairs);
+					passes++;
+				} while (timer.ElapsedSeconds() < 0.5 && passes < 1000);
+				double seconds = timer.ElapsedSeconds() / passes;
+
+				std::vector<BodyPair> contacts = NarrowPhase(spheres, transforms, pairs);
+				const char *identical = "-";
+				if (type == BroadphaseType::BruteForce)
+				{
+					reference = contacts;
+					hasReference = true;
+				}
+				else if (hasReference)
+				{
+					identical = contacts == reference ? "yes" : "NO";
+				}
+
+				printf("%-14s %8u %8s %12zu %10zu %12.3f %14.0f %10s\n", BroadphaseName(type), bodyCount, scene, pairs.size(), contacts.size(),
+					   seconds * 1000.0, static_cast<double>(pairs.size()) / seconds, identical);
+
+				const std::string test = std::string(BroadphaseName(type)) + "/" + scene;
+				Record("broadphase", test, bodyCount, "candidates", static_cast<double>(pairs.size()));
+				Record("broadphase", test, bodyCount, "contacts", static_cast<double>(contacts.size()));
+				Record("broadphase", test, bodyCount, "ms_per_pass", seconds * 1000.0);
+				if (type != BroadphaseType::BruteForce && hasReference)
+					Record("broadphase", test, bodyCount, "identical", contacts == reference);
+			}
+		}
+
+		void RunBroadphaseBenchmarks()
+		{
+			const uint32_t bodyCounts[] = {1000, 10000, 100000};
+			std::vector<SphereCollider> spheres;
+			std::vector<Transform> transforms;
+			std::vector<BroadphaseProxy> proxies;
+
+			printf("%-14s %8s %8s %12s %10s %12s %14s %10s\n", "broadphase", "bodies", "scene", "candidates", "contacts", "ms/pass", "pairs/s", "identical");
+			for (uint32_t bodyCount : bodyCounts)
+			{
+				// Keep density constant (~8 units^3 per unit sphere) so only the body count changes
+				BuildScene(bodyCount, 8.0f, spheres, transforms, proxies);
+				RunBroadphases("uniform", spheres, transforms, proxies);
+
+				// Split into layers the way a game would: a few units colliding with everything and many pickups
+				// only colliding with units, so pickup pairs are dropped before their bounds are compared
+				for (uint32_t i = 0; i < bodyCount; i++)
+					proxies[i].Filter = i % 10 == 0 ? CollisionFilter{1, CollisionFilter::ALL} : CollisionFilter{2, 1};
+				RunBroadphases("layers", spheres, transforms, proxies);
+			}
+
+			// Same body count from scattered to packed, how pair testing scales with the pairs per body
+			const uint32_t densityBodies = 10000;
+			BuildScene(densityBodies, 64.0f, spheres, transforms, proxies);
+			RunBroadphases("sparse", spheres, transforms, proxies);
+			BuildScene(densityBodies, 2.0f, spheres, transforms, proxies);
+			RunBroadphases("packed", spheres, transforms, proxies);
+		}
+	}
+}
@@ -0,0 +1,125 @@
+#include "Bench.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "BodyStore.h"
+#include "ContactCache.h"
+
+namespace flg
+{
+	namespace bench
+	{
+		// The end of PhysicsWorld::ResolveCollision on its own: contacts go through the cache to find their transitions,
+		// then every transition is dispatched through std::function like the world's callbacks.
+		// Contacts are a window over a chain of pairs, churn moves the window so some pairs exit and others enter every step.
+		static void RunDispatch(const char *name, uint32_t contactCount, uint32_t churnPerStep)
+		{
+			const uint32_t pairCount = contactCount * 2;
+			const uint32_t steps = 100;
+
+			BodyStore store;
+			std::vector<BodyHandle> handles(pairCount + 1);
+			for (BodyHandle &handle : handles)
+				handle = store.Create(BodyState{});
+
+			// Shuffled so the contact list reaches the cache out of key order, like pairs coming from the broadphase
+			std::mt19937 rng(GetOptions().Seed);
+			std::vector<uint32_t> order(contactCount);
+			for (uint32_t i = 0; i < contactCount; i++)
+				order[i] = i;
+			std::shuffle(order.begin(), order.end(), rng);
+
+			uint64_t enters = 0;
+			uint64_t stays = 0;
+			uint64_t exits = 0;
+			std::function<void(CollisionPoints &, uint32_t, uint32_t)> onEnter = [&enters](CollisionPoints &, uint32_t, uint32_t)
+			{ enters++; };
+			std::function<void(CollisionPoints &, uint32_t, uint32_t)> onStay = [&stays](CollisionPoints &, uint32_t, uint32_t)
+			{ stays++; };
+			std::function<void(CollisionPoints &, uint32_t, uint32_t)> onExit = [&exits](CollisionPoints &, uint32_t, uint32_t)
+			{ exits++; };
+
+			ContactCache cache;
+			std::vector<Contact> contacts;
+			std::vector<ContactTransition> transitions;
+			double updateSeconds = 0.0;
+			double dispatchSeconds = 0.0;
+			uint64_t transitionCount = 0;
+			for (uint32_t step = 0; step <= steps; step++)
+			{
+				const uint32_t offset = step * churnPerStep;
+				for (uint32_t i : order)
+				{
+					uint32_t pair = (offset + i) % pairCount;
+					Contact contact;
+					contact.A = handles[pair];
+					contact.B = handles[pair + 1];
+					contact.Key = ContactCache::MakeKey(contact.A, contact.B);
+					contact.EntityA = pair;
+					contact.EntityB = pair + 1;
+					contacts.push_back(contact);
+				}
+
+				Timer timer;
+				cache.Update(contacts, transitions, store);
+				double update = timer.ElapsedSeconds();
+
+				timer.Reset();
+				for (const ContactTransition &transition : transitions)
+				{
+					if (transition.State == ContactState::Exit)
+					{
+						Contact contact = cache.GetPreviousContacts()[transition.Index];
+						onExit(contact.Points, contact.EntityA, contact.EntityB);
+						continue;
+					}
+
+					Contact contact = cache.GetContacts()[transition.Index];
+					if (transition.State == ContactState::Enter)
+						onEnter(contact.Points, contact.EntityA, contact.EntityB);
+					else
+						onStay(contact.Points, contact.EntityA, contact.EntityB);
+				}
+				double dispatch = timer.ElapsedSeconds();
+
+				// The first step only fills the cache
+				if (step == 0)
+					continue;
+
+				updateSeconds += update;
+				dispatchSeconds += dispatch;
+				transitionCount += transitions.size();
+			}
+
+			double updateNs = updateSeconds * 1e9 / transitionCount;
+			double dispatchNs = dispatchSeconds * 1e9 / transitionCount;
+			printf("%-14s %8u %10llu %10llu %12.1f %12.1f %10.1f\n", name, contactCount, static_cast<unsigned long long>(enters),
+				   static_cast<unsigned long long>(exits), updateNs, dispatchNs, updateNs + dispatchNs);
+
+			Record("callbacks", name, contactCount, "enters", static_cast<double>(enters));
+			Record("callbacks", name, contactCount, "stays", static_cast<double>(stays));
+			Record("callbacks", name, contactCount, "exits", static_cast<double>(exits));
+			Record("callbacks", name, contactCount, "update_ns_per_event", updateNs);
+			Record("callbacks", name, contactCount, "dispatch_ns_per_event", dispatchNs);
+		}
+
+		void RunCallbackBenchmarks()
+		{
+			const uint32_t contactCounts[] = {1000, 10000, 100000};
+
+			printf("\n%-14s %8s %10s %10s %12s %12s %10s\n", "callbacks", "contacts", "enters", "exits", "update ns", "dispatch ns", "ns/event");
+			for (uint32_t contactCount : contactCounts)
+			{
+				// Every pair stays in contact, the resting case
+				RunDispatch("stay", contactCount, 0);
+
+				// A tenth of the pairs leave and as many new ones enter every step
+				RunDispatch("churn", contactCount, contactCount / 10);
+			}
+		}
+	}
+}
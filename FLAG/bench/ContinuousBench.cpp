@@ -0,0 +1,95 @@
+#include "Bench.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Physics.h"
+
+namespace flg
+{
+	namespace bench
+	{
+		// Small fast spheres shot at a wall of static spheres standing on the floor, counting the shots that came out the other side.
+		// A field of slow bodies next to it shows what sweeping costs the bodies that do not need it.
+		static void RunShots(float dt, bool continuous)
+		{
+			const uint32_t wallSize = 20;
+			const uint32_t shotCount = 500;
+			const uint32_t fieldSize = 100;
+			const float shotSpeed = 300.0f;
+
+			PhysicsWorldProperties properties;
+			properties.ContinuousCollision = continuous;
+			PhysicsWorld world(properties);
+
+			std::vector<SphereCollider> wallSpheres(wallSize * wallSize, SphereCollider{glm::vec3{0.0f}, 0.75f});
+			std::vector<Body> wall(wallSize * wallSize);
+			for (uint32_t i = 0; i < wall.size(); i++)
+			{
+				wall[i].SetPosition(glm::vec3{0.0f, 1.15f + static_cast<float>(i / wallSize), static_cast<float>(i % wallSize)});
+				wall[i].SetCollider(&wallSpheres[i]);
+				wall[i].SetEntityOwnerID(i);
+				world.AddBody(&wall[i]);
+			}
+
+			std::vector<SphereCollider> fieldSpheres(fieldSize * fieldSize, SphereCollider{glm::vec3{0.0f}, 1.0f});
+			std::vector<Body> field(fieldSize * fieldSize);
+			for (uint32_t i = 0; i < field.size(); i++)
+			{
+				field[i].SetPosition(glm::vec3{50.0f + static_cast<float>(i % fieldSize) * 2.5f, 1.39f, static_cast<float>(i / fieldSize) * 2.5f});
+				field[i].SetVelocity(glm::vec3{1.0f, 0.0f, 0.0f});
+				field[i].SetCollider(&fieldSpheres[i]);
+				field[i].SetType(BodyType::Dynamic);
+				field[i].SetEntityOwnerID(static_cast<uint32_t>(wall.size()) + i);
+				world.AddBody(&field[i]);
+			}
+
+			std::mt19937 rng(GetOptions().Seed);
+			std::uniform_real_distribution<float> spread(0.0f, static_cast<float>(wallSize - 1));
+			std::vector<SphereCollider> shotSpheres(shotCount, SphereCollider{glm::vec3{0.0f}, 0.1f});
+			std::vector<Body> shots(shotCount);
+			for (uint32_t i = 0; i < shotCount; i++)
+			{
+				shots[i].SetPosition(glm::vec3{-30.0f, 1.15f + spread(rng), spread(rng)});
+				shots[i].SetVelocity(glm::vec3{shotSpeed, 0.0f, 0.0f});
+				shots[i].SetCollider(&shotSpheres[i]);
+				shots[i].SetType(BodyType::Dynamic);
+				shots[i].SetEntityOwnerID(static_cast<uint32_t>(wall.size() + field.size()) + i);
+				world.AddBody(&shots[i]);
+			}
+
+			// Long enough for every shot to reach the wall
+			const uint32_t steps = static_cast<uint32_t>(0.5f / dt);
+			Timer timer;
+			for (uint32_t step = 0; step < steps; step++)
+				world.Step(dt);
+			double seconds = timer.ElapsedSeconds() / steps;
+
+			uint32_t tunneled = 0;
+			for (const Body &shot : shots)
+				tunneled += shot.GetPosition().x > 1.0f;
+
+			printf("%-14s %8zu %8.1f %12.3f %10u %10u\n", continuous ? "swept" : "discrete", wall.size() + field.size() + shots.size(), dt * 1000.0f,
+				   seconds * 1000.0, shotCount, tunneled);
+
+			const std::string test = std::string(continuous ? "swept" : "discrete") + "/dt" + std::to_string(static_cast<int>(dt * 1000.0f + 0.5f));
+			Record("continuous", test, shots.size(), "ms_per_step", seconds * 1000.0);
+			Record("continuous", test, shots.size(), "tunneled", tunneled);
+
+			shots.clear();
+			field.clear();
+			wall.clear();
+		}
+
+		void RunContinuousBenchmarks()
+		{
+			printf("\n%-14s %8s %8s %12s %10s %10s\n", "continuous", "bodies", "dt ms", "ms/step", "shots", "tunneled");
+			for (float dt : {1.0f / 60.0f, 1.0f / 30.0f})
+			{
+				RunShots(dt, false);
+				RunShots(dt, true);
+			}
+		}
+	}
+}
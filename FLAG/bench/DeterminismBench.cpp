@@ -0,0 +1,108 @@
+#include "Bench.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Physics.h"
+#include "Replay.h"
+
+namespace flg
+{
+	namespace bench
+	{
+		// Falling bodies that get kicked, removed and added while recording, like a game would between steps
+		static void RecordScene(PhysicsWorld &world, PhysicsRecording &recording, uint32_t bodyCount, uint32_t steps)
+		{
+			std::mt19937 rng(GetOptions().Seed);
+			float extent = 0.5f * glm::pow(8.0f * static_cast<float>(bodyCount), 1.0f / 3.0f);
+
+			std::vector<SphereCollider> spheres(bodyCount * 2, SphereCollider{glm::vec3{0.0f}, 1.0f});
+			std::vector<std::unique_ptr<Body>> bodies;
+			auto addBody = [&]()
+			{
+				uint32_t id = static_cast<uint32_t>(bodies.size());
+				bodies.push_back(std::make_unique<Body>());
+				Body &body = *bodies.back();
+				body.SetPosition(RandomPoint(rng, extent) + glm::vec3{0.0f, extent + 2.0f, 0.0f});
+				body.SetCollider(&spheres[id]);
+				body.SetType(id % 8 == 0 ? BodyType::Static : BodyType::Dynamic);
+				body.SetEntityOwnerID(id);
+				world.AddBody(&body);
+			};
+
+			for (uint32_t i = 0; i < bodyCount; i++)
+				addBody();
+
+			world.StartRecording(&recording);
+			std::uniform_int_distribution<uint32_t> pick(0, bodyCount - 1);
+			for (uint32_t step = 0; step < steps; step++)
+			{
+				bodies[pick(rng)]->SetVelocity(RandomPoint(rng, 10.0f));
+				if (step % 10 == 0)
+				{
+					world.RemoveBody(bodies[pick(rng)].get());
+					if (bodies.size() < spheres.size())
+						addBody();
+				}
+
+				world.Step(1.0f / 60.0f);
+			}
+			world.StopRecording();
+
+			bodies.clear();
+			world.Clear();
+		}
+
+		void RunDeterminismChecks()
+		{
+			const uint32_t bodyCount = 5000;
+			const uint32_t steps = 120;
+			const std::string path = "flagella_determinism.flgr";
+
+			PhysicsWorld world;
+			PhysicsRecording recording;
+			Timer timer;
+			RecordScene(world, recording, bodyCount, steps);
+			double recordSeconds = timer.ElapsedSeconds();
+
+			PhysicsRecording loaded;
+			bool saved = recording.Save(path) && loaded.Load(path);
+			std::remove(path.c_str());
+
+			printf("\n%-14s %8s %8s %12s %10s %10s\n", "replay", "bodies", "threads", "ms/step", "steps", "matched");
+			printf("%-14s %8u %8u %12.3f %10u %10s\n", "record", bodyCount, 1u, recordSeconds * 1000.0 / steps, steps, saved ? "saved" : "NOT SAVED");
+			Record("determinism", "record", bodyCount, "ms_per_step", recordSeconds * 1000.0 / steps);
+
+			std::vector<uint32_t> threadCounts = {1, 4};
+			if (std::thread::hardware_concurrency() > 4)
+				threadCounts.push_back(std::thread::hardware_concurrency());
+
+			for (uint32_t threadCount : threadCounts)
+			{
+				world.SetThreadCount(threadCount);
+				timer.Reset();
+				ReplayResult result = ReplayRecording(world, loaded);
+				double seconds = timer.ElapsedSeconds() / steps;
+
+				printf("%-14s %8u %8u %12.3f %10u %10s\n", "replay", bodyCount, world.GetThreadCount(), seconds * 1000.0,
+					   result.StepsReplayed, result.Matched() ? "yes" : "NO");
+
+				const std::string test = "replay/threads" + std::to_string(threadCount);
+				Record("determinism", test, bodyCount, "ms_per_step", seconds * 1000.0);
+				Record("determinism", test, bodyCount, "matched", result.Matched());
+			}
+
+			// A nudged input has to be caught at the step it happened on
+			PhysicsRecording nudged = loaded;
+			const uint32_t nudgedStep = steps / 2;
+			nudged.Steps[nudgedStep].Edits.front().Velocity.x += 1e-3f;
+			ReplayResult result = ReplayRecording(world, nudged);
+			printf("%-14s %8u %8u %12s %10lld %10s\n", "nudged input", bodyCount, world.GetThreadCount(), "-",
+				   static_cast<long long>(result.FirstMismatch), result.FirstMismatch == nudgedStep ? "caught" : "MISSED");
+			Record("determinism", "nudged input", bodyCount, "caught", result.FirstMismatch == nudgedStep);
+		}
+	}
+}
@@ -0,0 +1,212 @@
+#include "Bench.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include "Algorithms.h"
+#include "BatchAlgorithms.h"
+#include "Body.h"
+#include "Collider.h"
+#include "Shape.h"
+
+namespace flg
+{
+	namespace bench
+	{
+		static void RecordKernels(const char *test, uint32_t size, uint32_t hits, double scalarSeconds, double batchSeconds, bool identical)
+		{
+			Record("narrowphase", test, size, "hits", hits);
+			Record("narrowphase", test, size, "scalar_ms", scalarSeconds * 1000.0);
+			Record("narrowphase", test, size, "batch_ms", batchSeconds * 1000.0);
+			Record("narrowphase", test, size, "identical", identical);
+		}
+
+		void RunNarrowphaseBenchmarks()
+		{
+			const uint32_t sphereCounts[] = {64, 1024, 16384};
+
+			printf("\nnarrowphase kernel: %s\n", algo::GetBatchKernelName());
+			printf("%-14s %8s %10s %12s %12s %10s %10s\n", "test", "spheres", "hits", "scalar ms", "batch ms", "speedup", "identical");
+			for (uint32_t sphereCount : sphereCounts)
+			{
+				std::mt19937 rng(GetOptions().Seed);
+				std::uniform_real_distribution<float> radiusDist(0.5f, 1.5f);
+				float extent = 0.5f * glm::pow(8.0f * static_cast<float>(sphereCount), 1.0f / 3.0f);
+
+				std::vector<SphereCollider> spheres(sphereCount);
+				std::vector<Transform> transforms(sphereCount);
+				algo::SpherePacket packet;
+				for (uint32_t i = 0; i < sphereCount; i++)
+				{
+					spheres[i].Radius = radiusDist(rng);
+					transforms[i].Position = RandomPoint(rng, extent);
+					packet.Push(transforms[i].Position + spheres[i].Center, spheres[i].Radius);
+				}
+
+				// --- Sphere against spheres ---
+				SphereCollider query{glm::vec3{0.0f}, 2.0f};
+				Transform queryTransform;
+
+				// Through the Collider overload like PhysicsWorld, so the double dispatch orders the points the same way
+				const Collider *queryCollider = &query;
+				std::vector<CollisionPoints> scalarPoints(sphereCount);
+				uint32_t passes = 0;
+				Timer timer;
+				do
+				{
+					for (uint32_t i = 0; i < sphereCount; i++)
+						scalarPoints[i] = queryCollider->TestCollision(&queryTransform, static_cast<const Collider *>(&spheres[i]), &transforms[i]);
+					passes++;
+				} while (timer.ElapsedSeconds() < 0.25);
+				double scalarSeconds = timer.ElapsedSeconds() / passes;
+
+				algo::SphereBatchContacts contacts;
+				passes = 0;
+				timer.Reset();
+				do
+				{
+					algo::TestSphereBatch(queryTransform.Position + query.Center, query.Radius, packet, contacts);
+					passes++;
+				} while (timer.ElapsedSeconds() < 0.25);
+				double batchSeconds = timer.ElapsedSeconds() / passes;
+
+				uint32_t hits = 0;
+				bool identical = true;
+				for (uint32_t i = 0; i < sphereCount; i++)
+				{
+					bool hit = contacts.Hits.IsHit(i);
+					hits += hit;
+					identical &= hit == scalarPoints[i].DidCollide;
+					identical &= !hit || contacts.GetDelta(i) / 2.0f == scalarPoints[i].A;
+				}
+
+				printf("%-14s %8u %10u %12.4f %12.4f %9.1fx %10s\n", "sphere-sphere", sphereCount, hits, scalarSeconds * 1000.0, batchSeconds * 1000.0,
+					   scalarSeconds / batchSeconds, identical ? "yes" : "NO");
+				RecordKernels("sphere-sphere", sphereCount, hits, scalarSeconds, batchSeconds, identical);
+
+				// --- Ray against spheres ---
+				Ray ray{glm::vec3{-extent, 0.0f, 0.0f}, glm::vec3{1.0f, 0.0f, 0.0f}};
+
+				passes = 0;
+				timer.Reset();
+				do
+				{
+					for (uint32_t i = 0; i < sphereCount; i++)
+						scalarPoints[i] = spheres[i].TestCollision(&transforms[i], &ray, nullptr);
+					passes++;
+				} while (timer.ElapsedSeconds() < 0.25);
+				scalarSeconds = timer.ElapsedSeconds() / passes;
+
+				algo::RayBatchHits rayHits;
+				passes = 0;
+				timer.Reset();
+				do
+				{
+					algo::TestRaySphereBatch(&ray, packet, rayHits);
+					passes++;
+				} while (timer.ElapsedSeconds() < 0.25);
+				batchSeconds = timer.ElapsedSeconds() / passes;
+
+				hits = 0;
+				identical = true;
+				for (uint32_t i = 0; i < sphereCount; i++)
+				{
+					bool hit = rayHits.Hits.IsHit(i);
+					hits += hit;
+					identical &= hit == scalarPoints[i].DidCollide;
+					identical &= !hit || ray.Origin + (ray.Direction * rayHits.TFar[i]) == scalarPoints[i].A;
+				}
+
+				printf("%-14s %8u %10u %12.4f %12.4f %9.1fx %10s\n", "ray-sphere", sphereCount, hits, scalarSeconds * 1000.0, batchSeconds * 1000.0,
+					   scalarSeconds / batchSeconds, identical ? "yes" : "NO");
+				RecordKernels("ray-sphere", sphereCount, hits, scalarSeconds, batchSeconds, identical);
+
+				// --- Mixed shape pairs, Collider API against shapes bucketed by combination ---
+				std::vector<PlaneCollider> planes(sphereCount / 8, PlaneCollider{glm::vec3{0.0f}, glm::vec3{0.0f, 1.0f, 0.0f}, glm::vec3{10.0f}});
+				std::vector<Ray> rays(sphereCount / 8, Ray{glm::vec3{0.0f}, glm::vec3{1.0f, 0.0f, 0.0f}});
+				std::vector<const Collider *> colliders;
+				for (SphereCollider &sphere : spheres)
+					colliders.push_back(&sphere);
+				for (uint32_t i = 0; i < planes.size(); i++)
+				{
+					planes[i].Origin = RandomPoint(rng, extent);
+					rays[i] = Ray{RandomPoint(rng, extent), glm::normalize(RandomPoint(rng, 1.0f))};
+					colliders.push_back(&planes[i]);
+					colliders.push_back(&rays[i]);
+				}
+
+				std::vector<Shape> shapes;
+				std::vector<glm::vec3> positions;
+				for (const Collider *collider : colliders)
+				{
+					shapes.push_back(Shape::FromCollider(collider));
+					positions.push_back(RandomPoint(rng, extent));
+				}
+
+				// Pairs grouped by combination like the world's narrowphase does per chunk
+				const uint32_t pairCount = sphereCount * 4;
+				std::uniform_int_distribution<uint32_t> pick(0, static_cast<uint32_t>(colliders.size()) - 1);
+				std::vector<std::pair<uint32_t, uint32_t>> pairs(pairCount);
+				for (auto &pair : pairs)
+					pair = {pick(rng), pick(rng)};
+				std::stable_sort(pairs.begin(), pairs.end(), [&shapes](const auto &a, const auto &b)
+								 { return std::make_pair(shapes[a.first].Type, shapes[a.second].Type) < std::make_pair(shapes[b.first].Type, shapes[b.second].Type); });
+
+				std::vector<CollisionPoints> apiPoints(pairCount);
+				std::vector<Transform> pairTransforms(colliders.size());
+				for (uint32_t i = 0; i < colliders.size(); i++)
+					pairTransforms[i].Position = positions[i];
+
+				passes = 0;
+				timer.Reset();
+				do
+				{
+					for (uint32_t p = 0; p < pairCount; p++)
+						apiPoints[p] = colliders[pairs[p].first]->TestCollision(&pairTransforms[pairs[p].first], colliders[pairs[p].second], &pairTransforms[pairs[p].second]);
+					passes++;
+				} while (timer.ElapsedSeconds() < 0.25);
+				scalarSeconds = timer.ElapsedSeconds() / passes;
+
+				std::vector<CollisionPoints> tablePoints(pairCount);
+				passes = 0;
+				timer.Reset();
+				do
+				{
+					uint32_t runStart = 0;
+					while (runStart < pairCount)
+					{
+						const ColliderType typeA = shapes[pairs[runStart].first].Type;
+						const ColliderType typeB = shapes[pairs[runStart].second].Type;
+						uint32_t runEnd = runStart + 1;
+						while (runEnd < pairCount && shapes[pairs[runEnd].first].Type == typeA && shapes[pairs[runEnd].second].Type == typeB)
+							runEnd++;
+
+						const ShapeCollisionFn collide = GetShapeCollisionFn(typeA, typeB);
+						for (uint32_t p = runStart; p < runEnd; p++)
+						{
+							const auto &pair = pairs[p];
+							tablePoints[p] = collide ? collide(shapes[pair.first], positions[pair.first], shapes[pair.second], positions[pair.second]) : CollisionPoints{};
+						}
+						runStart = runEnd;
+					}
+					passes++;
+				} while (timer.ElapsedSeconds() < 0.25);
+				batchSeconds = timer.ElapsedSeconds() / passes;
+
+				hits = 0;
+				identical = true;
+				for (uint32_t p = 0; p < pairCount; p++)
+				{
+					hits += tablePoints[p].DidCollide;
+					identical &= tablePoints[p].DidCollide == apiPoints[p].DidCollide && (!tablePoints[p].DidCollide || tablePoints[p].A == apiPoints[p].A);
+				}
+
+				printf("%-14s %8u %10u %12.4f %12.4f %9.1fx %10s\n", "mixed pairs", pairCount, hits, scalarSeconds * 1000.0, batchSeconds * 1000.0,
+					   scalarSeconds / batchSeconds, identical ? "yes" : "NO");
+				RecordKernels("mixed pairs", pairCount, hits, scalarSeconds, batchSeconds, identical);
+			}
+		}
+	}
+}
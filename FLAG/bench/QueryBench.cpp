@@ -0,0 +1,160 @@
+#include "Bench.h"
+
+#include <cstdio>
+#include <vector>
+
+#include "Algorithms.h"
+#include "Physics.h"
+
+namespace flg
+{
+	namespace bench
+	{
+		// What PhysicsWorld::Raycast did before the query tree, but returning the nearest hit
+		static BodyHandle LinearRaycast(const BodyStore &bodies, const Ray &ray, float maxT)
+		{
+			BodyHandle nearest;
+			for (uint32_t i = 0; i < bodies.Size(); i++)
+			{
+				const SphereCollider *sphere = static_cast<const SphereCollider *>(bodies.Colliders[i]);
+				float t;
+				if (algo::FindRaySphereDistance(ray.Origin, ray.Direction, bodies.Positions.Get(i) + sphere->Center, sphere->Radius, t) && t <= maxT)
+				{
+					maxT = t;
+					nearest = bodies.Handles[i];
+				}
+			}
+			return nearest;
+		}
+
+		static uint32_t LinearOverlapSphere(const BodyStore &bodies, const glm::vec3 &center, float radius)
+		{
+			uint32_t count = 0;
+			for (uint32_t i = 0; i < bodies.Size(); i++)
+			{
+				const SphereCollider *sphere = static_cast<const SphereCollider *>(bodies.Colliders[i]);
+				count += glm::length(bodies.Positions.Get(i) + sphere->Center - center) < radius + sphere->Radius;
+			}
+			return count;
+		}
+
+		void RunQueryBenchmarks()
+		{
+			const uint32_t bodyCounts[] = {1000, 10000, 100000};
+			const uint32_t queryCount = 1000;
+			const float rayLength = 1000.0f;
+
+			printf("\n%-14s %8s %12s %12s %12s %10s %10s\n", "query", "bodies", "linear us", "tree us", "speedup", "hits", "identical");
+			for (uint32_t bodyCount : bodyCounts)
+			{
+				PhysicsWorld world;
+				std::mt19937 rng(GetOptions().Seed);
+				float extent = 0.5f * glm::pow(8.0f * static_cast<float>(bodyCount), 1.0f / 3.0f);
+
+				std::vector<SphereCollider> spheres(bodyCount, SphereCollider{glm::vec3{0.0f}, 1.0f});
+				std::vector<Body> bodies(bodyCount);
+				for (uint32_t i = 0; i < bodyCount; i++)
+				{
+					// Above the world floor so the step only moves bodies by their velocity
+					bodies[i].SetPosition(RandomPoint(rng, extent) + glm::vec3{0.0f, extent + 2.0f, 0.0f});
+					bodies[i].SetCollider(&spheres[i]);
+					bodies[i].SetType(BodyType::Kinematic);
+					bodies[i].SetVelocity(RandomPoint(rng, 1.0f));
+					world.AddBody(&bodies[i]);
+				}
+				const BodyStore &store = world.GetBodyStore();
+
+				std::vector<Ray> rays;
+				std::vector<glm::vec3> centers;
+				for (uint32_t q = 0; q < queryCount; q++)
+				{
+					rays.emplace_back(RandomPoint(rng, extent) + glm::vec3{0.0f, extent + 2.0f, 0.0f}, glm::normalize(RandomPoint(rng, 1.0f)));
+					centers.push_back(RandomPoint(rng, extent) + glm::vec3{0.0f, extent + 2.0f, 0.0f});
+				}
+
+				// Tree build on first query, then a refit after a step
+				Timer timer;
+				world.Raycast(&rays[0], rayLength);
+				double buildSeconds = timer.ElapsedSeconds();
+
+				world.Step(1.0f / 60.0f);
+				timer.Reset();
+				world.Raycast(&rays[0], rayLength);
+				double refitSeconds = timer.ElapsedSeconds();
+
+				printf("%-14s %8u %12s %12.1f %12s %10s %10s\n", "tree build", bodyCount, "-", buildSeconds * 1e6, "-", "-", "-");
+				printf("%-14s %8u %12s %12.1f %12s %10s %10s\n", "tree refit", bodyCount, "-", refitSeconds * 1e6, "-", "-", "-");
+				Record("query", "tree build", bodyCount, "us", buildSeconds * 1e6);
+				Record("query", "tree refit", bodyCount, "us", refitSeconds * 1e6);
+
+				// Nearest hit raycasts
+				std::vector<BodyHandle> linearHits(queryCount);
+				timer.Reset();
+				for (uint32_t q = 0; q < queryCount; q++)
+					linearHits[q] = LinearRaycast(store, rays[q], rayLength);
+				double linearSeconds = timer.ElapsedSeconds() / queryCount;
+
+				std::vector<BodyHandle> treeHits(queryCount);
+				timer.Reset();
+				for (uint32_t q = 0; q < queryCount; q++)
+					treeHits[q] = world.Raycast(&rays[q], rayLength).Handle;
+				double treeSeconds = timer.ElapsedSeconds() / queryCount;
+
+				uint32_t hits = 0;
+				for (const BodyHandle &handle : treeHits)
+					hits += handle.IsValid();
+
+				printf("%-14s %8u %12.2f %12.2f %11.1fx %10u %10s\n", "raycast", bodyCount, linearSeconds * 1e6, treeSeconds * 1e6,
+					   linearSeconds / treeSeconds, hits, linearHits == treeHits ? "yes" : "NO");
+				Record("query", "raycast", bodyCount, "linear_us", linearSeconds * 1e6);
+				Record("query", "raycast", bodyCount, "tree_us", treeSeconds * 1e6);
+				Record("query", "raycast", bodyCount, "hits", hits);
+				Record("query", "raycast", bodyCount, "identical", linearHits == treeHits);
+
+				// Same rays as one batch over every hardware thread, per ray time
+				std::vector<PhysicsWorld::Raycasthit> batchHits(queryCount);
+				world.SetThreadCount(0);
+				timer.Reset();
+				world.RaycastBatch(rays.data(), queryCount, batchHits.data(), rayLength);
+				double batchSeconds = timer.ElapsedSeconds() / queryCount;
+
+				bool identical = true;
+				for (uint32_t q = 0; q < queryCount; q++)
+					identical &= batchHits[q].Handle == treeHits[q];
+
+				printf("%-14s %8u %12.2f %12.2f %11.1fx %10u %10s\n", "raycast batch", bodyCount, linearSeconds * 1e6, batchSeconds * 1e6,
+					   linearSeconds / batchSeconds, hits, identical ? "yes" : "NO");
+				Record("query", "raycast batch", bodyCount, "us", batchSeconds * 1e6);
+				Record("query", "raycast batch", bodyCount, "identical", identical);
+
+				// Sphere overlaps
+				const float radius = 4.0f;
+				std::vector<uint32_t> linearCounts(queryCount);
+				timer.Reset();
+				for (uint32_t q = 0; q < queryCount; q++)
+					linearCounts[q] = LinearOverlapSphere(store, centers[q], radius);
+				linearSeconds = timer.ElapsedSeconds() / queryCount;
+
+				std::vector<uint32_t> treeCounts(queryCount);
+				std::vector<PhysicsWorld::OverlapHit> overlaps;
+				timer.Reset();
+				for (uint32_t q = 0; q < queryCount; q++)
+					treeCounts[q] = world.OverlapSphere(centers[q], radius, overlaps);
+				treeSeconds = timer.ElapsedSeconds() / queryCount;
+
+				hits = 0;
+				for (uint32_t count : treeCounts)
+					hits += count;
+
+				printf("%-14s %8u %12.2f %12.2f %11.1fx %10u %10s\n", "overlap sphere", bodyCount, linearSeconds * 1e6, treeSeconds * 1e6,
+					   linearSeconds / treeSeconds, hits, linearCounts == treeCounts ? "yes" : "NO");
+				Record("query", "overlap sphere", bodyCount, "linear_us", linearSeconds * 1e6);
+				Record("query", "overlap sphere", bodyCount, "tree_us", treeSeconds * 1e6);
+				Record("query", "overlap sphere", bodyCount, "hits", hits);
+				Record("query", "overlap sphere", bodyCount, "identical", linearCounts == treeCounts);
+
+				bodies.clear();
+			}
+		}
+	}
+}
@@ -0,0 +1,92 @@
+#include "Bench.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Physics.h"
+
+namespace flg
+{
+	namespace bench
+	{
+		// Deepest overlap between any two touching unit spheres
+		static float MaxPenetration(const PhysicsWorld &world)
+		{
+			const BodyStore &store = world.GetBodyStore();
+			float maxDepth = 0.0f;
+			for (const Contact &contact : world.GetContacts())
+			{
+				if (!store.IsAlive(contact.A) || !store.IsAlive(contact.B))
+					continue;
+
+				float distance = glm::length(store.Positions.Get(store.IndexOf(contact.B)) - store.Positions.Get(store.IndexOf(contact.A)));
+				maxDepth = glm::max(maxDepth, 2.0f - distance);
+			}
+			return maxDepth;
+		}
+
+		// Steps the scene the setup function built and prints one row per solver iteration count
+		template <typename SetupFn>
+		static void RunSolverScene(const char *name, uint32_t bodyCount, uint32_t steps, SetupFn setup)
+		{
+			const float dt = 1.0f / 60.0f;
+
+			printf("\n%-14s %8s %8s %12s %10s %10s\n", name, "bodies", "iters", "ms/step", "contacts", "max depth");
+			for (uint32_t iterations : {0u, 4u, 8u, 16u})
+			{
+				PhysicsWorldProperties properties;
+				properties.SolverIterations = iterations;
+				PhysicsWorld world(properties);
+
+				std::vector<SphereCollider> spheres(bodyCount, SphereCollider{glm::vec3{0.0f}, 1.0f});
+				std::vector<Body> bodies(bodyCount);
+				for (uint32_t i = 0; i < bodyCount; i++)
+				{
+					setup(bodies[i], i);
+					bodies[i].SetCollider(&spheres[i]);
+					bodies[i].SetType(BodyType::Dynamic);
+					bodies[i].SetEntityOwnerID(i);
+					world.AddBody(&bodies[i]);
+				}
+
+				Timer timer;
+				for (uint32_t step = 0; step < steps; step++)
+					world.Step(dt);
+				double seconds = timer.ElapsedSeconds() / steps;
+
+				float maxDepth = MaxPenetration(world);
+				printf("%-14s %8u %8u %12.3f %10zu %10.3f\n", "PhysicsWorld", bodyCount, iterations, seconds * 1000.0,
+					   world.GetContacts().size(), maxDepth);
+
+				const std::string test = std::string(name) + "/iters" + std::to_string(iterations);
+				Record("solver", test, bodyCount, "ms_per_step", seconds * 1000.0);
+				Record("solver", test, bodyCount, "contacts", static_cast<double>(world.GetContacts().size()));
+				Record("solver", test, bodyCount, "max_depth", maxDepth);
+
+				bodies.clear();
+			}
+		}
+
+		void RunSolverBenchmarks()
+		{
+			// Columns of spheres standing on the floor, the bottom contacts carry the whole column
+			const uint32_t columnHeight = 10;
+			const uint32_t columnsPerRow = 20;
+			RunSolverScene("stacked", columnHeight * columnsPerRow * columnsPerRow, 120, [=](Body &body, uint32_t i)
+						   {
+				uint32_t column = i / columnHeight;
+				glm::vec3 base{static_cast<float>(column % columnsPerRow) * 3.0f, 0.0f, static_cast<float>(column / columnsPerRow) * 3.0f};
+				body.SetPosition(base + glm::vec3{0.0f, 1.4f + 2.0f * static_cast<float>(i % columnHeight), 0.0f}); });
+
+			// Units spread over the floor all heading for the same spot, like a crowd converging on a target
+			const uint32_t unitCount = 5000;
+			RunSolverScene("crowded", unitCount, 120, [](Body &body, uint32_t i)
+						   {
+				std::mt19937 rng(GetOptions().Seed + i);
+				glm::vec3 position = RandomPoint(rng, 60.0f) * glm::vec3{1.0f, 0.0f, 1.0f} + glm::vec3{0.0f, 1.4f, 0.0f};
+				body.SetPosition(position);
+				body.SetVelocity(-position * glm::vec3{0.1f, 0.0f, 0.1f}); });
+		}
+	}
+}
@@ -0,0 +1,210 @@
+#include "Bench.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Physics.h"
+
+namespace flg
+{
+	namespace bench
+	{
+		// Falling bodies in a world of its own, returns the state hash after the last step
+		static uint64_t SimulateWorld(uint32_t seed, uint32_t bodyCount, uint32_t steps)
+		{
+			PhysicsWorld world;
+
+			std::mt19937 rng(GetOptions().Seed + seed);
+			float extent = 0.5f * glm::pow(8.0f * static_cast<float>(bodyCount), 1.0f / 3.0f);
+
+			std::vector<SphereCollider> spheres(bodyCount, SphereCollider{glm::vec3{0.0f}, 1.0f});
+			std::vector<Body> bodies(bodyCount);
+			for (uint32_t i = 0; i < bodyCount; i++)
+			{
+				bodies[i].SetPosition(RandomPoint(rng, extent) + glm::vec3{0.0f, extent + 2.0f, 0.0f});
+				bodies[i].SetCollider(&spheres[i]);
+				bodies[i].SetType(BodyType::Dynamic);
+				bodies[i].SetEntityOwnerID(i);
+				world.AddBody(&bodies[i]);
+			}
+
+			for (uint32_t step = 0; step < steps; step++)
+				world.Step(1.0f / 60.0f);
+			return world.ComputeStateHash();
+		}
+
+		// Bodies with no collider and nothing to rest on, so a step is only velocity and position integration
+		static void RunIntegration()
+		{
+			const float dt = 1.0f / 60.0f;
+
+			printf("\n%-14s %8s %8s %12s %10s\n", "integrate", "bodies", "threads", "ms/step", "Mbodies/s");
+			for (uint32_t bodyCount : {100000u, 1000000u})
+			{
+				PhysicsWorldProperties properties;
+				properties.WorldFloor = false;
+				properties.AllowSleeping = false;
+				properties.ContinuousCollision = false;
+				PhysicsWorld world(properties);
+
+				std::mt19937 rng(GetOptions().Seed);
+				std::vector<Body> bodies(bodyCount);
+				for (uint32_t i = 0; i < bodyCount; i++)
+				{
+					bodies[i].SetPosition(RandomPoint(rng, 100.0f));
+					bodies[i].SetVelocity(RandomPoint(rng, 1.0f));
+					bodies[i].SetType(BodyType::Dynamic);
+					bodies[i].SetEntityOwnerID(i);
+					world.AddBody(&bodies[i]);
+				}
+
+				// Warm up the body store and the broadphase scratch
+				world.Step(dt);
+
+				const uint32_t steps = 30;
+				Timer timer;
+				for (uint32_t step = 0; step < steps; step++)
+					world.Step(dt);
+				double seconds = timer.ElapsedSeconds() / steps;
+
+				printf("%-14s %8u %8u %12.3f %10.1f\n", "PhysicsWorld", bodyCount, world.GetThreadCount(), seconds * 1000.0,
+					   bodyCount / seconds / 1e6);
+				Record("step", "integrate", bodyCount, "ms_per_step", seconds * 1000.0);
+				Record("step", "integrate", bodyCount, "mbodies_per_s", bodyCount / seconds / 1e6);
+
+				bodies.clear();
+			}
+		}
+
+		void RunStepBenchmarks()
+		{
+			RunIntegration();
+
+			const uint32_t bodyCount = 50000;
+			const float dt = 1.0f / 60.0f;
+
+			std::vector<uint32_t> threadCounts = {1, 2, 4};
+			uint32_t hardwareThreads = std::thread::hardware_concurrency();
+			if (hardwareThreads > 4)
+				threadCounts.push_back(hardwareThreads);
+
+			printf("\n%-14s %8s %8s %12s %10s %10s\n", "step", "bodies", "threads", "ms/step", "events", "speedup");
+			double serialSeconds = 0.0;
+			for (uint32_t threadCount : threadCounts)
+			{
+				PhysicsWorld world;
+				world.SetThreadCount(threadCount);
+
+				std::mt19937 rng(GetOptions().Seed);
+				float extent = 0.5f * glm::pow(8.0f * static_cast<float>(bodyCount), 1.0f / 3.0f);
+
+				std::vector<SphereCollider> spheres(bodyCount, SphereCollider{glm::vec3{0.0f}, 1.0f});
+				std::vector<Body> bodies(bodyCount);
+				for (uint32_t i = 0; i < bodyCount; i++)
+				{
+					bodies[i].SetPosition(RandomPoint(rng, extent) + glm::vec3{0.0f, extent + 2.0f, 0.0f});
+					bodies[i].SetCollider(&spheres[i]);
+					bodies[i].SetType(BodyType::Dynamic);
+					bodies[i].SetEntityOwnerID(i);
+					world.AddBody(&bodies[i]);
+				}
+
+				uint64_t events = 0;
+				world.SetOnCollisionEnterCallBack([&events](CollisionPoints &, uint32_t, uint32_t)
+														  { events++; });
+
+				const uint32_t steps = 30;
+				Timer timer;
+				for (uint32_t step = 0; step < steps; step++)
+					world.Step(dt);
+				double seconds = timer.ElapsedSeconds() / steps;
+
+				if (threadCount == 1)
+					serialSeconds = seconds;
+
+				printf("%-14s %8u %8u %12.3f %10llu %9.2fx\n", "PhysicsWorld", bodyCount, world.GetThreadCount(), seconds * 1000.0,
+					   static_cast<unsigned long long>(events), serialSeconds / seconds);
+
+				const std::string test = "falling/threads" + std::to_string(threadCount);
+				Record("step", test, bodyCount, "ms_per_step", seconds * 1000.0);
+				Record("step", test, bodyCount, "events", static_cast<double>(events));
+
+				bodies.clear();
+			}
+
+			// Rows of touching bodies resting on the floor, the common case once a scene settles
+			printf("\n%-14s %8s %8s %12s %10s %10s\n", "resting", "bodies", "awake", "ms/step", "contacts", "speedup");
+			double awakeSeconds = 0.0;
+			for (bool allowSleeping : {false, true})
+			{
+				PhysicsWorld world;
+				world.SetAllowSleeping(allowSleeping);
+
+				const uint32_t rowLength = 250;
+				std::vector<SphereCollider> spheres(bodyCount, SphereCollider{glm::vec3{0.0f}, 1.0f});
+				std::vector<Body> bodies(bodyCount);
+				for (uint32_t i = 0; i < bodyCount; i++)
+				{
+					bodies[i].SetPosition(glm::vec3{static_cast<float>(i % rowLength) * 1.99f, 1.39f, static_cast<float>(i / rowLength) * 3.0f});
+					bodies[i].SetCollider(&spheres[i]);
+					bodies[i].SetType(BodyType::Dynamic);
+					world.AddBody(&bodies[i]);
+				}
+
+				// Long enough to fall asleep
+				for (uint32_t step = 0; step < 60; step++)
+					world.Step(dt);
+
+				const uint32_t steps = 30;
+				Timer timer;
+				for (uint32_t step = 0; step < steps; step++)
+					world.Step(dt);
+				double seconds = timer.ElapsedSeconds() / steps;
+
+				if (!allowSleeping)
+					awakeSeconds = seconds;
+
+				printf("%-14s %8u %8u %12.3f %10zu %9.2fx\n", allowSleeping ? "sleeping" : "no sleeping", bodyCount, world.GetBodyStore().AwakeCount,
+					   seconds * 1000.0, world.GetContacts().size(), awakeSeconds / seconds);
+
+				const std::string test = allowSleeping ? "resting/sleeping" : "resting/awake";
+				Record("step", test, bodyCount, "ms_per_step", seconds * 1000.0);
+				Record("step", test, bodyCount, "awake", world.GetBodyStore().AwakeCount);
+
+				bodies.clear();
+			}
+
+			// Independent worlds, like the runs of a parameter sweep, first one after the other and then each on its own thread.
+			// Every world has to end up where it did when it ran alone.
+			const uint32_t worldCount = std::max(2u, std::min(hardwareThreads, 8u));
+			const uint32_t worldBodies = 5000;
+			const uint32_t worldSteps = 60;
+
+			printf("\n%-14s %8s %8s %12s %10s %10s\n", "worlds", "bodies", "worlds", "ms/world", "identical", "speedup");
+			std::vector<uint64_t> serialHashes(worldCount);
+			Timer serialTimer;
+			for (uint32_t w = 0; w < worldCount; w++)
+				serialHashes[w] = SimulateWorld(w, worldBodies, worldSteps);
+			double serialWorldSeconds = serialTimer.ElapsedSeconds() / worldCount;
+			printf("%-14s %8u %8u %12.3f %10s %9.2fx\n", "sequential", worldBodies, worldCount, serialWorldSeconds * 1000.0, "-", 1.0);
+			Record("step", "worlds/sequential", worldBodies, "ms_per_world", serialWorldSeconds * 1000.0);
+
+			std::vector<uint64_t> concurrentHashes(worldCount);
+			std::vector<std::thread> threads;
+			Timer concurrentTimer;
+			for (uint32_t w = 0; w < worldCount; w++)
+				threads.emplace_back([&concurrentHashes, w, worldBodies, worldSteps]()
+									 { concurrentHashes[w] = SimulateWorld(w, worldBodies, worldSteps); });
+			for (std::thread &thread : threads)
+				thread.join();
+			double concurrentWorldSeconds = concurrentTimer.ElapsedSeconds() / worldCount;
+			printf("%-14s %8u %8u %12.3f %10s %9.2fx\n", "concurrent", worldBodies, worldCount, concurrentWorldSeconds * 1000.0,
+				   concurrentHashes == serialHashes ? "yes" : "NO", serialWorldSeconds / concurrentWorldSeconds);
+			Record("step", "worlds/concurrent", worldBodies, "ms_per_world", concurrentWorldSeconds * 1000.0);
+			Record("step", "worlds/concurrent", worldBodies, "identical", concurrentHashes == serialHashes);
+		}
+	}
+}
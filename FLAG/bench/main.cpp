@@ -0,0 +1,91 @@
+#include "Bench.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct Suite
+{
+	const char *Name;
+	void (*Run)();
+};
+
+static const Suite s_Suites[] = {
+	{"broadphase", flg::bench::RunBroadphaseBenchmarks},
+	{"narrowphase", flg::bench::RunNarrowphaseBenchmarks},
+	{"step", flg::bench::RunStepBenchmarks},
+	{"callbacks", flg::bench::RunCallbackBenchmarks},
+	{"query", flg::bench::RunQueryBenchmarks},
+	{"solver", flg::bench::RunSolverBenchmarks},
+	{"continuous", flg::bench::RunContinuousBenchmarks},
+	{"determinism", flg::bench::RunDeterminismChecks},
+};
+
+static void PrintUsage()
+{
+	printf("usage: flagella_bench [--seed N] [--csv path] [suite...]\n");
+	printf("runs every suite unless some are named:");
+	for (const Suite &suite : s_Suites)
+		printf(" %s", suite.Name);
+	printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+	flg::bench::Options &options = flg::bench::GetOptions();
+	std::vector<std::string> selected;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+		{
+			options.Seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+		}
+		else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc)
+		{
+			options.CsvPath = argv[++i];
+		}
+		else if (argv[i][0] != '-')
+		{
+			selected.push_back(argv[i]);
+		}
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	for (const std::string &name : selected)
+	{
+		bool known = false;
+		for (const Suite &suite : s_Suites)
+			known |= name == suite.Name;
+
+		if (!known)
+		{
+			printf("unknown suite %s\n", name.c_str());
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	printf("seed %u\n\n", options.Seed);
+	for (const Suite &suite : s_Suites)
+	{
+		bool run = selected.empty();
+		for (const std::string &name : selected)
+			run |= name == suite.Name;
+
+		if (run)
+			suite.Run();
+	}
+
+	if (!options.CsvPath.empty() && !flg::bench::WriteResults(options.CsvPath))
+	{
+		printf("could not write %s\n", options.CsvPath.c_str());
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,253 @@
+#include "AABBTree.h"
+
+#include <algorithm>
+
+namespace flg
+{
+	DynamicAABBTree::DynamicAABBTree(float margin)
+		: m_Margin(margin) {}
+
+	int32_t DynamicAABBTree::AllocateNode()
+	{
+		if (m_FreeList == NULL_NODE)
+		{
+			m_Nodes.emplace_back();
+			return static_cast<int32_t>(m_Nodes.size()) - 1;
+		}
+
+		int32_t node = m_FreeList;
+		m_FreeList = m_Nodes[node].Parent;
+		m_Nodes[node] = Node{};
+		return node;
+	}
+
+	void DynamicAABBTree::FreeNode(int32_t node)
+	{
+		m_Nodes[node].Parent = m_FreeList;
+		m_Nodes[node].Height = -1;
+		m_FreeList = node;
+	}
+
+	int32_t DynamicAABBTree::CreateProxy(const AABB &bounds, uint32_t userData)
+	{
+		int32_t proxy = AllocateNode();
+		m_Nodes[proxy].Bounds = AABB{bounds.Min - glm::vec3{m_Margin}, bounds.Max + glm::vec3{m_Margin}};
+		m_Nodes[proxy].UserData = userData;
+		m_Nodes[proxy].Height = 0;
+
+		InsertLeaf(proxy);
+		m_ProxyCount++;
+		return proxy;
+	}
+
+	void DynamicAABBTree::DestroyProxy(int32_t proxy)
+	{
+		RemoveLeaf(proxy);
+		FreeNode(proxy);
+		m_ProxyCount--;
+	}
+
+	bool DynamicAABBTree::MoveProxy(int32_t proxy, const AABB &bounds)
+	{
+		if (m_Nodes[proxy].Bounds.Contains(bounds))
+			return false;
+
+		RemoveLeaf(proxy);
+		m_Nodes[proxy].Bounds = AABB{bounds.Min - glm::vec3{m_Margin}, bounds.Max + glm::vec3{m_Margin}};
+		InsertLeaf(proxy);
+		return true;
+	}
+
+	void DynamicAABBTree::Clear()
+	{
+		m_Nodes.clear();
+		m_Root = NULL_NODE;
+		m_FreeList = NULL_NODE;
+		m_ProxyCount = 0;
+	}
+
+	void DynamicAABBTree::InsertLeaf(int32_t leaf)
+	{
+		if (m_Root == NULL_NODE)
+		{
+			m_Root = leaf;
+			m_Nodes[leaf].Parent = NULL_NODE;
+			return;
+		}
+
+		// Walk down to the cheapest sibling by surface area heuristic
+		const AABB leafBounds = m_Nodes[leaf].Bounds;
+		int32_t index = m_Root;
+		while (!m_Nodes[index].IsLeaf())
+		{
+			const Node &node = m_Nodes[index];
+			float area = node.Bounds.SurfaceArea();
+			float combinedArea = AABB::Merge(node.Bounds, leafBounds).SurfaceArea();
+
+			// Cost of making a new parent for this node and the leaf, and the cost pushed down to the children
+			float cost = 2.0f * combinedArea;
+			float inheritanceCost = 2.0f * (combinedArea - area);
+
+			auto childCost = [&](int32_t child)
+			{
+				const Node &childNode = m_Nodes[child];
+				float merged = AABB::Merge(childNode.Bounds, leafBounds).SurfaceArea();
+				return childNode.IsLeaf() ? merged + inheritanceCost : merged - childNode.Bounds.SurfaceArea() + inheritanceCost;
+			};
+
+			float cost1 = childCost(node.Child1);
+			float cost2 = childCost(node.Child2);
+			if (cost < cost1 && cost < cost2)
+				break;
+
+			index = cost1 < cost2 ? node.Child1 : node.Child2;
+		}
+
+		// New parent holding the sibling and the leaf
+		int32_t sibling = index;
+		int32_t oldParent = m_Nodes[sibling].Parent;
+		int32_t newParent = AllocateNode();
+		m_Nodes[newParent].Parent = oldParent;
+		m_Nodes[newParent].Bounds = AABB::Merge(leafBounds, m_Nodes[sibling].Bounds);
+		m_Nodes[newParent].Height = m_Nodes[sibling].Height + 1;
+		m_Nodes[newParent].Child1 = sibling;
+		m_Nodes[newParent].Child2 = leaf;
+		m_Nodes[sibling].Parent = newParent;
+		m_Nodes[leaf].Parent = newParent;
+
+		if (oldParent == NULL_NODE)
+			m_Root = newParent;
+		else if (m_Nodes[oldParent].Child1 == sibling)
+			m_Nodes[oldParent].Child1 = newParent;
+		else
+			m_Nodes[oldParent].Child2 = newParent;
+
+		// Refit and rebalance up to the root
+		index = m_Nodes[leaf].Parent;
+		while (index != NULL_NODE)
+		{
+			index = Balance(index);
+
+			Node &node = m_Nodes[index];
+			node.Height = 1 + std::max(m_Nodes[node.Child1].Height, m_Nodes[node.Child2].Height);
+			node.Bounds = AABB::Merge(m_Nodes[node.Child1].Bounds, m_Nodes[node.Child2].Bounds);
+			index = node.Parent;
+		}
+	}
+
+	void DynamicAABBTree::RemoveLeaf(int32_t leaf)
+	{
+		if (leaf == m_Root)
+		{
+			m_Root = NULL_NODE;
+			return;
+		}
+
+		int32_t parent = m_Nodes[leaf].Parent;
+		int32_t grandParent = m_Nodes[parent].Parent;
+		int32_t sibling = m_Nodes[parent].Child1 == leaf ? m_Nodes[parent].Child2 : m_Nodes[parent].Child1;
+
+		// The sibling takes the parent's place
+		FreeNode(parent);
+		m_Nodes[sibling].Parent = grandParent;
+		if (grandParent == NULL_NODE)
+		{
+			m_Root = sibling;
+			return;
+		}
+
+		if (m_Nodes[grandParent].Child1 == parent)
+			m_Nodes[grandParent].Child1 = sibling;
+		else
+			m_Nodes[grandParent].Child2 = sibling;
+
+		int32_t index = grandParent;
+		while (index != NULL_NODE)
+		{
+			index = Balance(index);
+
+			Node &node = m_Nodes[index];
+			node.Height = 1 + std::max(m_Nodes[node.Child1].Height, m_Nodes[node.Child2].Height);
+			node.Bounds = AABB::Merge(m_Nodes[node.Child1].Bounds, m_Nodes[node.Child2].Bounds);
+			index = node.Parent;
+		}
+	}
+
+	// Rotates the taller child up when the children's heights differ by more than one, returns the subtree root
+	int32_t DynamicAABBTree::Balance(int32_t a)
+	{
+		Node &nodeA = m_Nodes[a];
+		if (nodeA.IsLeaf() || nodeA.Height < 2)
+			return a;
+
+		int32_t b = nodeA.Child1;
+		int32_t c = nodeA.Child2;
+		int32_t balance = m_Nodes[c].Height - m_Nodes[b].Height;
+		if (balance > 1)
+		{
+			// Rotate c up
+			int32_t f = m_Nodes[c].Child1;
+			int32_t g = m_Nodes[c].Child2;
+			Node &nodeC = m_Nodes[c];
+
+			nodeC.Child1 = a;
+			nodeC.Parent = nodeA.Parent;
+			nodeA.Parent = c;
+
+			if (nodeC.Parent == NULL_NODE)
+				m_Root = c;
+			else if (m_Nodes[nodeC.Parent].Child1 == a)
+				m_Nodes[nodeC.Parent].Child1 = c;
+			else
+				m_Nodes[nodeC.Parent].Child2 = c;
+
+			// Keep the taller grandchild under c
+			if (m_Nodes[f].Height > m_Nodes[g].Height)
+				std::swap(f, g);
+
+			nodeC.Child2 = g;
+			nodeA.Child2 = f;
+			m_Nodes[f].Parent = a;
+
+			nodeA.Bounds = AABB::Merge(m_Nodes[b].Bounds, m_Nodes[f].Bounds);
+			nodeC.Bounds = AABB::Merge(nodeA.Bounds, m_Nodes[g].Bounds);
+			nodeA.Height = 1 + std::max(m_Nodes[b].Height, m_Nodes[f].Height);
+			nodeC.Height = 1 + std::max(nodeA.Height, m_Nodes[g].Height);
+			return c;
+		}
+
+		if (balance < -1)
+		{
+			// Rotate b up
+			int32_t d = m_Nodes[b].Child1;
+			int32_t e = m_Nodes[b].Child2;
+			Node &nodeB = m_Nodes[b];
+
+			nodeB.Child1 = a;
+			nodeB.Parent = nodeA.Parent;
+			nodeA.Parent = b;
+
+			if (nodeB.Parent == NULL_NODE)
+				m_Root = b;
+			else if (m_Nodes[nodeB.Parent].Child1 == a)
+				m_Nodes[nodeB.Parent].Child1 = b;
+			else
+				m_Nodes[nodeB.Parent].Child2 = b;
+
+			if (m_Nodes[d].Height > m_Nodes[e].Height)
+				std::swap(d, e);
+
+			nodeB.Child2 = e;
+			nodeA.Child1 = d;
+			m_Nodes[d].Parent = a;
+
+			nodeA.Bounds = AABB::Merge(m_Nodes[c].Bounds, m_Nodes[d].Bounds);
+			nodeB.Bounds = AABB::Merge(nodeA.Bounds, m_Nodes[e].Bounds);
+			nodeA.Height = 1 + std::max(m_Nodes[c].Height, m_Nodes[d].Height);
+			nodeB.Height = 1 + std::max(nodeA.Height, m_Nodes[e].Height);
+			return b;
+		}
+
+		return a;
+	}
+}
@@ -0,0 +1,175 @@
+#ifndef AABBTREE_H
+#define AABBTREE_H
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "Collider.h"
+
+namespace flg
+{
+    // Bounding volume hierarchy over proxies that move every step.
+    // Leaves store fattened bounds, so a proxy that moves a little only needs its tight bounds checked
+    // and is reinserted once it leaves them. Internal nodes are kept balanced with tree rotations.
+    class DynamicAABBTree
+    {
+    public:
+        static constexpr int32_t NULL_NODE = -1;
+
+        DynamicAABBTree(float margin = 0.5f);
+
+        int32_t CreateProxy(const AABB &bounds, uint32_t userData);
+        void DestroyProxy(int32_t proxy);
+
+        // Returns true if the proxy left its fat bounds and was reinserted
+        bool MoveProxy(int32_t proxy, const AABB &bounds);
+
+        void Clear();
+
+        uint32_t GetUserData(int32_t proxy) const { return m_Nodes[proxy].UserData; }
+        const AABB &GetFatBounds(int32_t proxy) const { return m_Nodes[proxy].Bounds; }
+        uint32_t GetProxyCount() const { return m_ProxyCount; }
+        int32_t GetHeight() const { return m_Root == NULL_NODE ? 0 : m_Nodes[m_Root].Height; }
+
+        // fn(proxy) is called for every proxy whose fat bounds overlap, return false to stop
+        template <typename Fn>
+        void QueryAABB(const AABB &bounds, Fn &&fn) const;
+
+        // fn(proxy) is called for every proxy whose fat bounds touch the sphere, return false to stop
+        template <typename Fn>
+        void QuerySphere(const glm::vec3 &center, float radius, Fn &&fn) const;
+
+        // Visits proxies whose fat bounds the ray enters before maxT (in units of direction).
+        // fn(proxy, maxT) returns the new maxT, so returning a hit's t prunes everything behind it and 0 stops.
+        template <typename Fn>
+        void Raycast(const glm::vec3 &origin, const glm::vec3 &direction, float maxT, Fn &&fn) const;
+
+    private:
+        struct Node
+        {
+            AABB Bounds;
+            uint32_t UserData = 0;
+            int32_t Parent = NULL_NODE; // Next free node while on the free list
+            int32_t Child1 = NULL_NODE;
+            int32_t Child2 = NULL_NODE;
+            int32_t Height = -1; // Leaf = 0, free = -1
+
+            bool IsLeaf() const { return Child1 == NULL_NODE; }
+        };
+
+        // Deep enough for any balanced tree that fits in memory
+        static constexpr int32_t MAX_STACK = 256;
+
+        int32_t AllocateNode();
+        void FreeNode(int32_t node);
+        void InsertLeaf(int32_t leaf);
+        void RemoveLeaf(int32_t leaf);
+        int32_t Balance(int32_t node);
+
+    private:
+        std::vector<Node> m_Nodes;
+        int32_t m_Root = NULL_NODE;
+        int32_t m_FreeList = NULL_NODE;
+        uint32_t m_ProxyCount = 0;
+        float m_Margin;
+    };
+
+    template <typename Fn>
+    void DynamicAABBTree::QueryAABB(const AABB &bounds, Fn &&fn) const
+    {
+        int32_t stack[MAX_STACK];
+        int32_t count = 0;
+        if (m_Root != NULL_NODE)
+            stack[count++] = m_Root;
+
+        while (count > 0)
+        {
+            const Node &node = m_Nodes[stack[--count]];
+            if (!node.Bounds.Overlaps(bounds))
+                continue;
+
+            if (node.IsLeaf())
+            {
+                if (!fn(static_cast<int32_t>(&node - m_Nodes.data())))
+                    return;
+            }
+            else
+            {
+                stack[count++] = node.Child1;
+                stack[count++] = node.Child2;
+            }
+        }
+    }
+
+    template <typename Fn>
+    void DynamicAABBTree::QuerySphere(const glm::vec3 &center, float radius, Fn &&fn) const
+    {
+        int32_t stack[MAX_STACK];
+        int32_t count = 0;
+        if (m_Root != NULL_NODE)
+            stack[count++] = m_Root;
+
+        const float radiusSquared = radius * radius;
+        while (count > 0)
+        {
+            const Node &node = m_Nodes[stack[--count]];
+            glm::vec3 closest = glm::clamp(center, node.Bounds.Min, node.Bounds.Max);
+            glm::vec3 offset = closest - center;
+            if (glm::dot(offset, offset) > radiusSquared)
+                continue;
+
+            if (node.IsLeaf())
+            {
+                if (!fn(static_cast<int32_t>(&node - m_Nodes.data())))
+                    return;
+            }
+            else
+            {
+                stack[count++] = node.Child1;
+                stack[count++] = node.Child2;
+            }
+        }
+    }
+
+    template <typename Fn>
+    void DynamicAABBTree::Raycast(const glm::vec3 &origin, const glm::vec3 &direction, float maxT, Fn &&fn) const
+    {
+        int32_t stack[MAX_STACK];
+        int32_t count = 0;
+        if (m_Root != NULL_NODE)
+            stack[count++] = m_Root;
+
+        const glm::vec3 inverseDirection = 1.0f / direction;
+        while (count > 0)
+        {
+            const Node &node = m_Nodes[stack[--count]];
+
+            // Slab test against the node, clipped to [0, maxT]
+            glm::vec3 t1 = (node.Bounds.Min - origin) * inverseDirection;
+            glm::vec3 t2 = (node.Bounds.Max - origin) * inverseDirection;
+            glm::vec3 tMin = glm::min(t1, t2);
+            glm::vec3 tMax = glm::max(t1, t2);
+            float enter = glm::max(glm::max(tMin.x, tMin.y), glm::max(tMin.z, 0.0f));
+            float exit = glm::min(glm::min(tMax.x, tMax.y), glm::min(tMax.z, maxT));
+            if (enter > exit)
+                continue;
+
+            if (node.IsLeaf())
+            {
+                maxT = fn(static_cast<int32_t>(&node - m_Nodes.data()), maxT);
+                if (maxT <= 0.0f)
+                    return;
+            }
+            else
+            {
+                stack[count++] = node.Child1;
+                stack[count++] = node.Child2;
+            }
+        }
+    }
+}
+
+#endif
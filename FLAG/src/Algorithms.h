@@ -3,36 +3,42 @@
 #include "Body.h"
 #include "Collider.h"
 
+#include <utility>
+
 namespace flg
 {
 	namespace algo
 	{
 		// --- Ray/Raycasts ---
-		static CollisionPoints FindRayPlaneCollisionPoints(const Ray *ray, const Collider *collider)
+		static inline CollisionPoints FindRayPlaneCollisionPoints(const Ray *ray, const Collider *collider)
 		{
 			// return collider->TestCollision((Collider*)(nullptr), ray, ray->Origin);
 			return CollisionPoints{};
 		}
-		static CollisionPoints FindRayPlaneCollisionPoints(const Ray *ray, const PlaneCollider *plane)
+		static inline CollisionPoints FindRayPlaneCollisionPoints(const glm::vec3 &rayOrigin, const glm::vec3 &rayDirection, const glm::vec3 &planeOrigin, const glm::vec3 &planeNormal)
 		{
 			// Rays' origin is a point on the plane.
-			if (ray->Origin == plane->Origin)
-				return CollisionPoints{ray->Origin, true};
+			if (rayOrigin == planeOrigin)
+				return CollisionPoints{rayOrigin, true};
 
 			// Ray and plane are perpendicular.
-			float rayDirectionDotPlaneNormal = glm::dot(ray->Direction, plane->Normal);
+			float rayDirectionDotPlaneNormal = glm::dot(rayDirection, planeNormal);
 			if (rayDirectionDotPlaneNormal == 0)
 				return CollisionPoints{glm::vec3{0.0f}, false};
 
-			float t = glm::dot(plane->Origin - ray->Origin, plane->Normal) / rayDirectionDotPlaneNormal;
-			return CollisionPoints{ray->Origin + (t * ray->Direction), t > 0 ? true : false};
+			float t = glm::dot(planeOrigin - rayOrigin, planeNormal) / rayDirectionDotPlaneNormal;
+			return CollisionPoints{rayOrigin + (t * rayDirection), t > 0 ? true : false};
+		}
+
+		static inline CollisionPoints FindRayPlaneCollisionPoints(const Ray *ray, const PlaneCollider *plane)
+		{
+			return FindRayPlaneCollisionPoints(ray->Origin, ray->Direction, plane->Origin, plane->Normal);
 		}
 
-		static CollisionPoints FindRaySphereCollisionPoints(const Ray *ray, const SphereCollider *sphere, const Transform *sphereTransform)
+		static inline CollisionPoints FindRaySphereCollisionPoints(const glm::vec3 &rayOrigin, const glm::vec3 &rayDirection, const glm::vec3 &sphereWorldCenter, float radius)
 		{
-			glm::vec3 sphereWorldCenter = sphereTransform->Position + sphere->Center;
-			float b = glm::dot(ray->Direction, ray->Origin - sphereWorldCenter);
-			float c = glm::dot(ray->Origin - sphereWorldCenter, ray->Origin - sphereWorldCenter) - (sphere->Radius * sphere->Radius);
+			float b = glm::dot(rayDirection, rayOrigin - sphereWorldCenter);
+			float c = glm::dot(rayOrigin - sphereWorldCenter, rayOrigin - sphereWorldCenter) - (radius * radius);
 
 			float discriminant = b * b - c;
 
@@ -45,21 +51,45 @@ namespace flg
 			float t1 = -b + discriminantRoot;
 			float t2 = -b - discriminantRoot;
 
-			float a = glm::dot(ray->Direction, ray->Direction);
+			float a = glm::dot(rayDirection, rayDirection);
 			t1 /= a;
 			t2 /= a;
 
-			return CollisionPoints{ray->Origin + (ray->Direction * t1), true};
+			return CollisionPoints{rayOrigin + (rayDirection * t1), true};
+		}
+
+		static inline CollisionPoints FindRaySphereCollisionPoints(const Ray *ray, const SphereCollider *sphere, const Transform *sphereTransform)
+		{
+			return FindRaySphereCollisionPoints(ray->Origin, ray->Direction, sphereTransform->Position + sphere->Center, sphere->Radius);
+		}
+
+		// Distance along the ray (in units of direction) to where it enters the sphere, or leaves it if the origin is inside.
+		// Returns false if the sphere is missed or lies behind the origin.
+		static inline bool FindRaySphereDistance(const glm::vec3 &origin, const glm::vec3 &direction, const glm::vec3 &center, float radius, float &t)
+		{
+			glm::vec3 offset = origin - center;
+			float a = glm::dot(direction, direction);
+			float b = glm::dot(direction, offset);
+			float c = glm::dot(offset, offset) - radius * radius;
+
+			float discriminant = b * b - a * c;
+			if (discriminant < 0 || a == 0)
+				return false;
+
+			float discriminantRoot = glm::sqrt(discriminant);
+			float tNear = (-b - discriminantRoot) / a;
+			float tFar = (-b + discriminantRoot) / a;
+
+			t = tNear >= 0 ? tNear : tFar;
+			return t >= 0;
 		}
 
 		// --- Physics Colliders Fns ---
-		static CollisionPoints FindSphereSphereColissionPoints(
-			const SphereCollider *a, const Transform *ta,
-			const SphereCollider *b, const Transform *tb)
+		static inline CollisionPoints FindSphereSphereColissionPoints(const glm::vec3 &centerA, float radiusA, const glm::vec3 &centerB, float radiusB)
 		{
-			glm::vec3 difference = (ta->Position + a->Center) - (tb->Position + b->Center);
+			glm::vec3 difference = centerA - centerB;
 			float differenceMagnitude = glm::length(difference);
-			float sumRadius = a->Radius + b->Radius;
+			float sumRadius = radiusA + radiusB;
 
 			if (differenceMagnitude < sumRadius)
 			{
@@ -69,18 +99,147 @@ namespace flg
 			return {};
 		}
 
-		static CollisionPoints FindSpherePlaneCollissionPoints(
+		static inline CollisionPoints FindSphereSphereColissionPoints(
+			const SphereCollider *a, const Transform *ta,
+			const SphereCollider *b, const Transform *tb)
+		{
+			return FindSphereSphereColissionPoints(ta->Position + a->Center, a->Radius, tb->Position + b->Center, b->Radius);
+		}
+
+		// Tangent axes of a plane with a normalized normal, the axes Bounds are measured along.
+		// Horizontal planes get x and z.
+		static inline void FindPlaneTangents(const glm::vec3 &normal, glm::vec3 &tangentU, glm::vec3 &tangentV)
+		{
+			glm::vec3 reference = glm::abs(normal.z) < 0.9f ? glm::vec3{0.0f, 0.0f, 1.0f} : glm::vec3{0.0f, 1.0f, 0.0f};
+			tangentU = glm::normalize(glm::cross(normal, reference));
+			tangentV = glm::cross(tangentU, normal);
+		}
+
+		// Direction the plane pushes the sphere out along and how deep the sphere is in. Bounds are half extents along the plane's
+		// tangents, 0 leaves that axis unbounded. Unbounded planes are half spaces, finite ones only catch spheres above or around them.
+		static inline bool FindSpherePlaneContact(const glm::vec3 &sphereWorldCenter, float radius, const glm::vec3 &planeWorldOrigin, const glm::vec3 &planeNormal,
+										   const glm::vec2 &planeBounds, glm::vec3 &pushDirection, float &depth)
+		{
+			float normalLength = glm::length(planeNormal);
+			if (normalLength == 0.0f)
+				return false;
+
+			glm::vec3 normal = planeNormal / normalLength;
+			glm::vec3 offset = sphereWorldCenter - planeWorldOrigin;
+			float distance = glm::dot(offset, normal);
+			if (planeBounds.x <= 0.0f && planeBounds.y <= 0.0f)
+			{
+				pushDirection = normal;
+				depth = radius - distance;
+				return depth > 0.0f;
+			}
+
+			glm::vec3 tangentU, tangentV;
+			FindPlaneTangents(normal, tangentU, tangentV);
+			float u = glm::dot(offset, tangentU);
+			float v = glm::dot(offset, tangentV);
+			float clampedU = planeBounds.x > 0.0f ? glm::clamp(u, -planeBounds.x, planeBounds.x) : u;
+			float clampedV = planeBounds.y > 0.0f ? glm::clamp(v, -planeBounds.y, planeBounds.y) : v;
+
+			// Over the face
+			if (clampedU == u && clampedV == v)
+			{
+				pushDirection = normal;
+				depth = radius - distance;
+				return depth > 0.0f && distance > -radius;
+			}
+
+			// Past an edge, pushed away from the closest point of the rim
+			glm::vec3 rimOffset = offset - (clampedU * tangentU + clampedV * tangentV);
+			float rimDistance = glm::length(rimOffset);
+			if (rimDistance >= radius || rimDistance == 0.0f)
+				return false;
+
+			pushDirection = rimOffset / rimDistance;
+			depth = radius - rimDistance;
+			return true;
+		}
+
+		// --- Sweeps ---
+		// Fraction of the motion after which a moving sphere first touches another, false if it misses within the motion.
+		// Spheres that already touch are left to the discrete test.
+		static inline bool FindSweptSphereSphereTime(const glm::vec3 &startCenter, const glm::vec3 &motion, float radius, const glm::vec3 &otherCenter,
+											  float otherRadius, float &t)
+		{
+			float combinedRadius = radius + otherRadius;
+			glm::vec3 offset = startCenter - otherCenter;
+			if (glm::dot(offset, offset) <= combinedRadius * combinedRadius)
+				return false;
+
+			return FindRaySphereDistance(startCenter, motion, otherCenter, combinedRadius, t) && t <= 1.0f;
+		}
+
+		// Same for a plane approached from its front, finite planes only count hits over their face
+		static inline bool FindSweptSpherePlaneTime(const glm::vec3 &startCenter, const glm::vec3 &motion, float radius, const glm::vec3 &planeWorldOrigin,
+											 const glm::vec3 &planeNormal, const glm::vec2 &planeBounds, float &t)
+		{
+			float normalLength = glm::length(planeNormal);
+			if (normalLength == 0.0f)
+				return false;
+
+			glm::vec3 normal = planeNormal / normalLength;
+			float startDistance = glm::dot(startCenter - planeWorldOrigin, normal);
+			float approach = -glm::dot(motion, normal);
+			if (startDistance <= radius || approach <= 0.0f)
+				return false;
+
+			t = (startDistance - radius) / approach;
+			if (t > 1.0f)
+				return false;
+			if (planeBounds.x <= 0.0f && planeBounds.y <= 0.0f)
+				return true;
+
+			glm::vec3 tangentU, tangentV;
+			FindPlaneTangents(normal, tangentU, tangentV);
+			glm::vec3 offset = startCenter + motion * t - planeWorldOrigin;
+			return (planeBounds.x <= 0.0f || glm::abs(glm::dot(offset, tangentU)) <= planeBounds.x) &&
+				   (planeBounds.y <= 0.0f || glm::abs(glm::dot(offset, tangentV)) <= planeBounds.y);
+		}
+
+		// A is the deepest point of the sphere, B the point of the plane it reached
+		static inline CollisionPoints FindSpherePlaneCollissionPoints(const glm::vec3 &sphereWorldCenter, float radius, const glm::vec3 &planeWorldOrigin,
+															   const glm::vec3 &planeNormal, const glm::vec2 &planeBounds)
+		{
+			glm::vec3 pushDirection;
+			float depth;
+			if (!FindSpherePlaneContact(sphereWorldCenter, radius, planeWorldOrigin, planeNormal, planeBounds, pushDirection, depth))
+				return {};
+
+			CollisionPoints points;
+			points.A = sphereWorldCenter - pushDirection * radius;
+			points.B = points.A + pushDirection * depth;
+			points.NormalDelta = pushDirection;
+			points.MagnitudeDelta = depth;
+			points.DidCollide = true;
+			return points;
+		}
+
+		static inline CollisionPoints FindPlaneSphereCollissionPoints(const glm::vec3 &planeWorldOrigin, const glm::vec3 &planeNormal, const glm::vec2 &planeBounds,
+															   const glm::vec3 &sphereWorldCenter, float radius)
+		{
+			CollisionPoints points = FindSpherePlaneCollissionPoints(sphereWorldCenter, radius, planeWorldOrigin, planeNormal, planeBounds);
+			std::swap(points.A, points.B);
+			points.NormalDelta = -points.NormalDelta;
+			return points;
+		}
+
+		static inline CollisionPoints FindSpherePlaneCollissionPoints(
 			const SphereCollider *a, const Transform *ta,
 			const PlaneCollider *b, const Transform *tb)
 		{
-			return {};
+			return FindSpherePlaneCollissionPoints(ta->Position + a->Center, a->Radius, tb->Position + b->Origin, b->Normal, b->Bounds);
 		}
 
-		static CollisionPoints FindPlaneSphereCollissionPoints(
+		static inline CollisionPoints FindPlaneSphereCollissionPoints(
 			const PlaneCollider *a, const Transform *ta,
 			const SphereCollider *b, const Transform *tb)
 		{
-			return {};
+			return FindPlaneSphereCollissionPoints(ta->Position + a->Origin, a->Normal, a->Bounds, tb->Position + b->Center, b->Radius);
 		}
 	}
-}
\ No newline at end of file
+}
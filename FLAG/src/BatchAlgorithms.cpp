@@ -0,0 +1,189 @@
+#include "BatchAlgorithms.h"
+
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define FLG_BATCH_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FLG_BATCH_SSE
+#endif
+
+namespace flg
+{
+	namespace algo
+	{
+		const char *GetBatchKernelName()
+		{
+#if defined(FLG_BATCH_AVX2)
+			return "AVX2";
+#elif defined(FLG_BATCH_SSE)
+			return "SSE";
+#else
+			return "Scalar";
+#endif
+		}
+
+		// Scalar versions, also used for the tail of the SIMD loops.
+		// Operations are ordered like the glm code in Algorithms.h so both paths give the same bits.
+		static void TestSphereRange(uint32_t begin, uint32_t end, const glm::vec3 &center, float radius, const SpherePacket &spheres, SphereBatchContacts &contacts)
+		{
+			for (uint32_t i = begin; i < end; i++)
+			{
+				float dx = spheres.X[i] - center.x;
+				float dy = spheres.Y[i] - center.y;
+				float dz = spheres.Z[i] - center.z;
+				float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+				contacts.DeltaX[i] = dx;
+				contacts.DeltaY[i] = dy;
+				contacts.DeltaZ[i] = dz;
+				if (distance < radius + spheres.Radius[i])
+					contacts.Hits.Bits[i >> 5] |= 1u << (i & 31);
+			}
+		}
+
+		static void TestRayRange(uint32_t begin, uint32_t end, const Ray *ray, const SpherePacket &spheres, RayBatchHits &hits)
+		{
+			const glm::vec3 &origin = ray->Origin;
+			const glm::vec3 &direction = ray->Direction;
+			float a = direction.x * direction.x + direction.y * direction.y + direction.z * direction.z;
+
+			for (uint32_t i = begin; i < end; i++)
+			{
+				float ox = origin.x - spheres.X[i];
+				float oy = origin.y - spheres.Y[i];
+				float oz = origin.z - spheres.Z[i];
+				float b = direction.x * ox + direction.y * oy + direction.z * oz;
+				float c = (ox * ox + oy * oy + oz * oz) - spheres.Radius[i] * spheres.Radius[i];
+				float discriminant = b * b - c;
+
+				float root = std::sqrt(discriminant);
+				hits.TFar[i] = (-b + root) / a;
+				hits.TNear[i] = (-b - root) / a;
+				if (!(discriminant < 0))
+					hits.Hits.Bits[i >> 5] |= 1u << (i & 31);
+			}
+		}
+
+		void TestSphereBatch(const glm::vec3 &center, float radius, const SpherePacket &spheres, SphereBatchContacts &contacts)
+		{
+			const uint32_t count = spheres.Size();
+			contacts.Hits.Reset(count);
+			contacts.DeltaX.resize(count);
+			contacts.DeltaY.resize(count);
+			contacts.DeltaZ.resize(count);
+
+			uint32_t i = 0;
+#if defined(FLG_BATCH_AVX2)
+			const __m256 cx = _mm256_set1_ps(center.x);
+			const __m256 cy = _mm256_set1_ps(center.y);
+			const __m256 cz = _mm256_set1_ps(center.z);
+			const __m256 r = _mm256_set1_ps(radius);
+			for (; i + 8 <= count; i += 8)
+			{
+				__m256 dx = _mm256_sub_ps(_mm256_loadu_ps(&spheres.X[i]), cx);
+				__m256 dy = _mm256_sub_ps(_mm256_loadu_ps(&spheres.Y[i]), cy);
+				__m256 dz = _mm256_sub_ps(_mm256_loadu_ps(&spheres.Z[i]), cz);
+				__m256 lengthSquared = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+				__m256 sumRadius = _mm256_add_ps(r, _mm256_loadu_ps(&spheres.Radius[i]));
+				__m256 hit = _mm256_cmp_ps(_mm256_sqrt_ps(lengthSquared), sumRadius, _CMP_LT_OQ);
+
+				_mm256_storeu_ps(&contacts.DeltaX[i], dx);
+				_mm256_storeu_ps(&contacts.DeltaY[i], dy);
+				_mm256_storeu_ps(&contacts.DeltaZ[i], dz);
+				contacts.Hits.Bits[i >> 5] |= static_cast<uint32_t>(_mm256_movemask_ps(hit)) << (i & 31);
+			}
+#elif defined(FLG_BATCH_SSE)
+			const __m128 cx = _mm_set1_ps(center.x);
+			const __m128 cy = _mm_set1_ps(center.y);
+			const __m128 cz = _mm_set1_ps(center.z);
+			const __m128 r = _mm_set1_ps(radius);
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128 dx = _mm_sub_ps(_mm_loadu_ps(&spheres.X[i]), cx);
+				__m128 dy = _mm_sub_ps(_mm_loadu_ps(&spheres.Y[i]), cy);
+				__m128 dz = _mm_sub_ps(_mm_loadu_ps(&spheres.Z[i]), cz);
+				__m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+				__m128 sumRadius = _mm_add_ps(r, _mm_loadu_ps(&spheres.Radius[i]));
+				__m128 hit = _mm_cmplt_ps(_mm_sqrt_ps(lengthSquared), sumRadius);
+
+				_mm_storeu_ps(&contacts.DeltaX[i], dx);
+				_mm_storeu_ps(&contacts.DeltaY[i], dy);
+				_mm_storeu_ps(&contacts.DeltaZ[i], dz);
+				contacts.Hits.Bits[i >> 5] |= static_cast<uint32_t>(_mm_movemask_ps(hit)) << (i & 31);
+			}
+#endif
+			TestSphereRange(i, count, center, radius, spheres, contacts);
+		}
+
+		void TestRaySphereBatch(const Ray *ray, const SpherePacket &spheres, RayBatchHits &hits)
+		{
+			const uint32_t count = spheres.Size();
+			hits.Hits.Reset(count);
+			hits.TNear.resize(count);
+			hits.TFar.resize(count);
+
+			uint32_t i = 0;
+#if defined(FLG_BATCH_AVX2)
+			const glm::vec3 &direction = ray->Direction;
+			const __m256 ox = _mm256_set1_ps(ray->Origin.x);
+			const __m256 oy = _mm256_set1_ps(ray->Origin.y);
+			const __m256 oz = _mm256_set1_ps(ray->Origin.z);
+			const __m256 dirX = _mm256_set1_ps(direction.x);
+			const __m256 dirY = _mm256_set1_ps(direction.y);
+			const __m256 dirZ = _mm256_set1_ps(direction.z);
+			const __m256 a = _mm256_set1_ps(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+			const __m256 zero = _mm256_setzero_ps();
+			for (; i + 8 <= count; i += 8)
+			{
+				__m256 dx = _mm256_sub_ps(ox, _mm256_loadu_ps(&spheres.X[i]));
+				__m256 dy = _mm256_sub_ps(oy, _mm256_loadu_ps(&spheres.Y[i]));
+				__m256 dz = _mm256_sub_ps(oz, _mm256_loadu_ps(&spheres.Z[i]));
+				__m256 radius = _mm256_loadu_ps(&spheres.Radius[i]);
+
+				__m256 b = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dirX, dx), _mm256_mul_ps(dirY, dy)), _mm256_mul_ps(dirZ, dz));
+				__m256 c = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz)), _mm256_mul_ps(radius, radius));
+				__m256 discriminant = _mm256_sub_ps(_mm256_mul_ps(b, b), c);
+				__m256 root = _mm256_sqrt_ps(discriminant);
+				__m256 minusB = _mm256_sub_ps(zero, b);
+
+				_mm256_storeu_ps(&hits.TFar[i], _mm256_div_ps(_mm256_add_ps(minusB, root), a));
+				_mm256_storeu_ps(&hits.TNear[i], _mm256_div_ps(_mm256_sub_ps(minusB, root), a));
+				__m256 hit = _mm256_cmp_ps(discriminant, zero, _CMP_NLT_UQ);
+				hits.Hits.Bits[i >> 5] |= static_cast<uint32_t>(_mm256_movemask_ps(hit)) << (i & 31);
+			}
+#elif defined(FLG_BATCH_SSE)
+			const glm::vec3 &direction = ray->Direction;
+			const __m128 ox = _mm_set1_ps(ray->Origin.x);
+			const __m128 oy = _mm_set1_ps(ray->Origin.y);
+			const __m128 oz = _mm_set1_ps(ray->Origin.z);
+			const __m128 dirX = _mm_set1_ps(direction.x);
+			const __m128 dirY = _mm_set1_ps(direction.y);
+			const __m128 dirZ = _mm_set1_ps(direction.z);
+			const __m128 a = _mm_set1_ps(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+			const __m128 zero = _mm_setzero_ps();
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128 dx = _mm_sub_ps(ox, _mm_loadu_ps(&spheres.X[i]));
+				__m128 dy = _mm_sub_ps(oy, _mm_loadu_ps(&spheres.Y[i]));
+				__m128 dz = _mm_sub_ps(oz, _mm_loadu_ps(&spheres.Z[i]));
+				__m128 radius = _mm_loadu_ps(&spheres.Radius[i]);
+
+				__m128 b = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dirX, dx), _mm_mul_ps(dirY, dy)), _mm_mul_ps(dirZ, dz));
+				__m128 c = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)), _mm_mul_ps(radius, radius));
+				__m128 discriminant = _mm_sub_ps(_mm_mul_ps(b, b), c);
+				__m128 root = _mm_sqrt_ps(discriminant);
+				__m128 minusB = _mm_sub_ps(zero, b);
+
+				_mm_storeu_ps(&hits.TFar[i], _mm_div_ps(_mm_add_ps(minusB, root), a));
+				_mm_storeu_ps(&hits.TNear[i], _mm_div_ps(_mm_sub_ps(minusB, root), a));
+				__m128 hit = _mm_cmpnlt_ps(discriminant, zero);
+				hits.Hits.Bits[i >> 5] |= static_cast<uint32_t>(_mm_movemask_ps(hit)) << (i & 31);
+			}
+#endif
+			TestRayRange(i, count, ray, spheres, hits);
+		}
+	}
+}
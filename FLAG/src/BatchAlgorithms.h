@@ -0,0 +1,81 @@
+#ifndef BATCHALGORITHMS_H
+#define BATCHALGORITHMS_H
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "Collider.h"
+
+namespace flg
+{
+    namespace algo
+    {
+        // Spheres in world space packed one array per component, the layout the batch kernels read
+        struct SpherePacket
+        {
+            std::vector<float> X;
+            std::vector<float> Y;
+            std::vector<float> Z;
+            std::vector<float> Radius;
+
+            uint32_t Size() const { return static_cast<uint32_t>(X.size()); }
+
+            void Push(const glm::vec3 &center, float radius)
+            {
+                X.push_back(center.x);
+                Y.push_back(center.y);
+                Z.push_back(center.z);
+                Radius.push_back(radius);
+            }
+
+            void Clear()
+            {
+                X.clear();
+                Y.clear();
+                Z.clear();
+                Radius.clear();
+            }
+        };
+
+        // One bit per tested sphere
+        struct HitMask
+        {
+            std::vector<uint32_t> Bits;
+
+            bool IsHit(uint32_t index) const { return (Bits[index >> 5] >> (index & 31)) & 1; }
+            void Reset(uint32_t count) { Bits.assign((count + 31) / 32, 0); }
+        };
+
+        // Sphere against packet. Delta is the packet sphere's center minus the query sphere's center
+        struct SphereBatchContacts
+        {
+            HitMask Hits;
+            std::vector<float> DeltaX;
+            std::vector<float> DeltaY;
+            std::vector<float> DeltaZ;
+
+            glm::vec3 GetDelta(uint32_t index) const { return glm::vec3{DeltaX[index], DeltaY[index], DeltaZ[index]}; }
+        };
+
+        // Ray against packet. Hit points are Origin + Direction * T
+        struct RayBatchHits
+        {
+            HitMask Hits;
+            std::vector<float> TNear;
+            std::vector<float> TFar;
+        };
+
+        // Name of the kernel compiled in (AVX2, SSE or Scalar)
+        const char *GetBatchKernelName();
+
+        // Same results as FindSphereSphereColissionPoints for every sphere in the packet
+        void TestSphereBatch(const glm::vec3 &center, float radius, const SpherePacket &spheres, SphereBatchContacts &contacts);
+
+        // Same results as FindRaySphereCollisionPoints for every sphere in the packet
+        void TestRaySphereBatch(const Ray *ray, const SpherePacket &spheres, RayBatchHits &hits);
+    }
+}
+
+#endif
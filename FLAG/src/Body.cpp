@@ -0,0 +1,236 @@
+#include "Body.h"
+#include "BodyStore.h"
+
+namespace flg
+{
+	Body::Body(uint32_t ownerEntityID)
+	{
+		m_State.OwnerEntityID = ownerEntityID;
+	}
+
+	Body::Body(const Body &other)
+		: m_State(other.GetState()) {}
+
+	Body::Body(Body &&other) noexcept
+		: m_State(other.m_State), m_Handle(other.m_Handle), m_Store(other.m_Store)
+	{
+		other.m_Handle = {};
+		other.m_Store = nullptr;
+	}
+
+	Body &Body::operator=(const Body &other)
+	{
+		if (this != &other)
+		{
+			if (IsRegistered())
+				m_Store->Destroy(m_Handle);
+
+			m_State = other.GetState();
+			m_Handle = {};
+			m_Store = nullptr;
+		}
+		return *this;
+	}
+
+	Body &Body::operator=(Body &&other) noexcept
+	{
+		if (this != &other)
+		{
+			if (IsRegistered())
+				m_Store->Destroy(m_Handle);
+
+			m_State = other.m_State;
+			m_Handle = other.m_Handle;
+			m_Store = other.m_Store;
+			other.m_Handle = {};
+			other.m_Store = nullptr;
+		}
+		return *this;
+	}
+
+	Body::~Body()
+	{
+		if (IsRegistered())
+			m_Store->Destroy(m_Handle);
+	}
+
+	bool Body::IsRegistered() const
+	{
+		return m_Store != nullptr && m_Store->IsAlive(m_Handle);
+	}
+
+	BodyState Body::GetState() const
+	{
+		return IsRegistered() ? m_Store->GetState(m_Store->IndexOf(m_Handle)) : m_State;
+	}
+
+	glm::vec3 Body::GetPosition() const
+	{
+		return IsRegistered() ? m_Store->Positions.Get(m_Store->IndexOf(m_Handle)) : m_State.Position;
+	}
+
+	void Body::SetPosition(const glm::vec3 &newPositon, bool retainVelocity)
+	{
+		if (IsRegistered())
+		{
+			// Teleport, do not interpolate from the old position
+			uint32_t index = m_Store->Wake(m_Store->IndexOf(m_Handle));
+			m_Store->Positions.Set(index, newPositon);
+			m_Store->PreviousPositions.Set(index, newPositon);
+			m_Store->Dirty = true;
+			m_Store->ProxiesDirty = true; // Static bodies stay outside the awake range
+		}
+		else
+			m_State.Position = newPositon;
+	}
+
+	glm::vec3 Body::GetInterpolatedPosition(float alpha) const
+	{
+		if (!IsRegistered())
+			return m_State.Position;
+
+		uint32_t index = m_Store->IndexOf(m_Handle);
+		return glm::mix(m_Store->PreviousPositions.Get(index), m_Store->Positions.Get(index), alpha);
+	}
+
+	glm::vec3 Body::GetVelocity() const
+	{
+		return IsRegistered() ? m_Store->Velocities.Get(m_Store->IndexOf(m_Handle)) : m_State.Velocity;
+	}
+
+	void Body::SetVelocity(const glm::vec3 &velocity)
+	{
+		if (IsRegistered())
+			m_Store->Velocities.Set(m_Store->Wake(m_Store->IndexOf(m_Handle)), velocity);
+		else
+			m_State.Velocity = velocity;
+	}
+
+	glm::vec3 Body::GetForce() const
+	{
+		return IsRegistered() ? m_Store->Forces.Get(m_Store->IndexOf(m_Handle)) : m_State.Force;
+	}
+
+	void Body::SetForce(const glm::vec3 &force)
+	{
+		if (IsRegistered())
+			m_Store->Forces.Set(m_Store->Wake(m_Store->IndexOf(m_Handle)), force);
+		else
+			m_State.Force = force;
+	}
+
+	void Body::AddForce(const glm::vec3 &force)
+	{
+		if (IsRegistered())
+		{
+			uint32_t index = m_Store->Wake(m_Store->IndexOf(m_Handle));
+			m_Store->Forces.Set(index, m_Store->Forces.Get(index) + force);
+		}
+		else
+			m_State.Force += force;
+	}
+
+	float Body::GetMass() const
+	{
+		return GetState().Mass;
+	}
+
+	void Body::SetMass(float mass)
+	{
+		if (IsRegistered())
+			m_Store->SetMass(m_Store->Wake(m_Store->IndexOf(m_Handle)), mass);
+		else
+			m_State.Mass = mass;
+	}
+
+	BodyType Body::GetType() const
+	{
+		return IsRegistered() ? m_Store->Types[m_Store->IndexOf(m_Handle)] : m_State.Type;
+	}
+
+	void Body::SetType(BodyType type)
+	{
+		if (IsRegistered())
+			m_Store->SetType(m_Store->IndexOf(m_Handle), type);
+		else
+			m_State.Type = type;
+	}
+
+	Collider *Body::GetCollider() const
+	{
+		return IsRegistered() ? m_Store->Colliders[m_Store->IndexOf(m_Handle)] : m_State.BodyCollider;
+	}
+
+	void Body::SetCollider(Collider *collider)
+	{
+		if (IsRegistered())
+		{
+			uint32_t index = m_Store->Wake(m_Store->IndexOf(m_Handle));
+			m_Store->Colliders[index] = collider;
+			m_Store->Shapes[index] = Shape::FromCollider(collider);
+			m_Store->Dirty = true;
+			m_Store->ProxiesDirty = true;
+		}
+		else
+			m_State.BodyCollider = collider;
+	}
+
+	void Body::SetEntityOwnerID(uint32_t id)
+	{
+		if (IsRegistered())
+			m_Store->OwnerEntityIDs[m_Store->IndexOf(m_Handle)] = id;
+		else
+			m_State.OwnerEntityID = id;
+	}
+
+	bool Body::IsAwake() const
+	{
+		return IsRegistered() && m_Store->IsAwake(m_Store->IndexOf(m_Handle));
+	}
+
+	void Body::WakeUp()
+	{
+		if (IsRegistered())
+			m_Store->Wake(m_Store->IndexOf(m_Handle));
+	}
+
+	uint32_t Body::GetEntityOwnerID() const
+	{
+		return IsRegistered() ? m_Store->OwnerEntityIDs[m_Store->IndexOf(m_Handle)] : m_State.OwnerEntityID;
+	}
+
+	bool Body::HasContinuousCollision() const
+	{
+		return IsRegistered() ? m_Store->ContinuousCollision[m_Store->IndexOf(m_Handle)] != 0 : m_State.ContinuousCollision;
+	}
+
+	void Body::SetContinuousCollision(bool enabled)
+	{
+		if (IsRegistered())
+			m_Store->ContinuousCollision[m_Store->IndexOf(m_Handle)] = enabled;
+		else
+			m_State.ContinuousCollision = enabled;
+	}
+
+	CollisionFilter Body::GetCollisionFilter() const
+	{
+		return IsRegistered() ? m_Store->Filters[m_Store->IndexOf(m_Handle)] : m_State.Filter;
+	}
+
+	void Body::SetCollisionFilter(const CollisionFilter &filter)
+	{
+		if (IsRegistered())
+		{
+			uint32_t index = m_Store->IndexOf(m_Handle);
+			if (m_Store->Filters[index] == filter)
+				return;
+
+			// Sleeping pairs are carried over untested, waking the body gets them through the new filter
+			index = m_Store->Wake(index);
+			m_Store->Filters[index] = filter;
+			m_Store->ProxiesDirty = true;
+		}
+		else
+			m_State.Filter = filter;
+	}
+}
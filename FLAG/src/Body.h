@@ -4,6 +4,7 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <cstdint>
 
 namespace flg
 {
@@ -24,35 +25,113 @@ namespace flg
             : Position(0.0f), Rotation(0.0f), Scale(1.0f) {}
     };
 
+    // Stable reference to a body in a BodyStore. Stays valid while bodies around it are added and removed.
+    struct BodyHandle
+    {
+        static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+        uint32_t Index = INVALID_INDEX;
+        uint32_t Generation = 0;
+
+        bool IsValid() const { return Index != INVALID_INDEX; }
+        bool operator==(const BodyHandle &other) const { return Index == other.Index && Generation == other.Generation; }
+        bool operator!=(const BodyHandle &other) const { return !(*this == other); }
+    };
+
+    // Two bodies are only tested against each other when each one's category shares a bit with the other's mask
+    struct CollisionFilter
+    {
+        static constexpr uint32_t ALL = 0xFFFFFFFF;
+
+        uint32_t Category = 1;
+        uint32_t Mask = ALL;
+
+        bool CanCollide(const CollisionFilter &other) const { return (Category & other.Mask) != 0 && (other.Category & Mask) != 0; }
+        bool operator==(const CollisionFilter &other) const { return Category == other.Category && Mask == other.Mask; }
+        bool operator!=(const CollisionFilter &other) const { return !(*this == other); }
+    };
+
     struct Collider;
-    struct Body
+
+    // Full state of a body, used to create it in a store and to hold it while unregistered
+    struct BodyState
     {
-        Transform BodyTransform;
-        glm::vec3 Velocity;
-        glm::vec3 Force;
-        float Mass;
+        glm::vec3 Position{0.0f};
+        glm::vec3 Velocity{0.0f};
+        glm::vec3 Force{0.0f};
+        float Mass = 1.0f;
 
-        BodyType Type;
-        Collider *BodyCollider;
-        bool UseGravity;
+        BodyType Type = BodyType::Static;
+        Collider *BodyCollider = nullptr;
+        uint32_t OwnerEntityID = -1;
+        bool ContinuousCollision = false;
+        CollisionFilter Filter;
+    };
 
-        Body(uint32_t ownerEntityID = -1)
-            : OwnerEntityID(ownerEntityID), BodyTransform({}), Velocity(0.0f), Force(0.0f), Mass(1.0f), Type(BodyType::Static), BodyCollider(nullptr)
-        {
-        }
+    class BodyStore;
 
-        const glm::vec3 &GetPosition() { return BodyTransform.Position; };
+    // Handle to a body living in the physics world's BodyStore. Until the body is added
+    // to a world it keeps its own state, which is copied into the store by PhysicsWorld::AddBody.
+    // Copying a body copies its state, not its registration. Destroying a registered body removes it from the store.
+    class Body
+    {
+    public:
+        Body(uint32_t ownerEntityID = -1);
+        Body(const Body &other);
+        Body(Body &&other) noexcept;
+        Body &operator=(const Body &other);
+        Body &operator=(Body &&other) noexcept;
+        ~Body();
 
-        void SetPosition(const glm::vec3 &newPositon, bool retainVelocity = false)
-        {
-            BodyTransform.Position = newPositon;
-        };
+        glm::vec3 GetPosition() const;
+        void SetPosition(const glm::vec3 &newPositon, bool retainVelocity = false);
 
-        void SetEntityOwnerID(uint32_t id) { OwnerEntityID = id; };
-        uint32_t GetEntityOwnerID() { return OwnerEntityID; };
+        // Position between the previous and the current step, alpha from PhysicsWorld::GetInterpolationAlpha
+        glm::vec3 GetInterpolatedPosition(float alpha) const;
+
+        glm::vec3 GetVelocity() const;
+        void SetVelocity(const glm::vec3 &velocity);
+
+        glm::vec3 GetForce() const;
+        void SetForce(const glm::vec3 &force);
+        void AddForce(const glm::vec3 &force);
+
+        float GetMass() const;
+        void SetMass(float mass);
+
+        BodyType GetType() const;
+        void SetType(BodyType type);
+
+        Collider *GetCollider() const;
+        void SetCollider(Collider *collider);
+
+        void SetEntityOwnerID(uint32_t id);
+        uint32_t GetEntityOwnerID() const;
+
+        // Sweeps the body every step so it can not pass through others, not only once it moves fast (see PhysicsWorldProperties)
+        bool HasContinuousCollision() const;
+        void SetContinuousCollision(bool enabled);
+
+        // Pairs failing the filter are dropped by the broadphase, changing it wakes the body so its pairs are tested again
+        CollisionFilter GetCollisionFilter() const;
+        void SetCollisionFilter(const CollisionFilter &filter);
+
+        // Registered non static bodies sleep after resting for a while, setting their state wakes them up
+        bool IsAwake() const;
+        void WakeUp();
+
+        // Snapshot of the current state, read from the store if registered
+        BodyState GetState() const;
+
+        BodyHandle GetHandle() const { return m_Handle; }
+        bool IsRegistered() const;
 
     private:
-        uint32_t OwnerEntityID;
+        BodyState m_State;
+        BodyHandle m_Handle;
+        BodyStore *m_Store = nullptr;
+
+        friend class PhysicsWorld;
     };
 }
-#endif
\ No newline at end of file
+#endif
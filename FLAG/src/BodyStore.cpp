@@ -0,0 +1,244 @@
+#include "BodyStore.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace flg
+{
+	BodyHandle BodyStore::Create(const BodyState &state)
+	{
+		uint32_t slot;
+		if (!m_FreeSlots.empty())
+		{
+			slot = m_FreeSlots.back();
+			m_FreeSlots.pop_back();
+		}
+		else
+		{
+			slot = static_cast<uint32_t>(m_Sparse.size());
+			m_Sparse.push_back(BodyHandle::INVALID_INDEX);
+			m_Generations.push_back(0);
+		}
+
+		BodyHandle handle;
+		handle.Index = slot;
+		handle.Generation = m_Generations[slot];
+
+		uint32_t index = Size();
+		m_Sparse[slot] = index;
+
+		Positions.PushBack(state.Position);
+		PreviousPositions.PushBack(state.Position);
+		Velocities.PushBack(state.Velocity);
+		Forces.PushBack(state.Force);
+		InverseMasses.push_back(0.0f);
+		Types.push_back(BodyType::Static);
+		MotionFactors.push_back(0.0f);
+		GravityFactors.push_back(0.0f);
+		Colliders.push_back(state.BodyCollider);
+		Shapes.push_back(Shape::FromCollider(state.BodyCollider));
+		OwnerEntityIDs.push_back(state.OwnerEntityID);
+		Handles.push_back(handle);
+		SleepTimers.push_back(0.0f);
+		ContinuousCollision.push_back(state.ContinuousCollision);
+		Filters.push_back(state.Filter);
+
+		// Added as static then woken by SetType if it moves
+		SetMass(index, state.Mass);
+		SetType(index, state.Type);
+		Dirty = true;
+		ProxiesDirty = true;
+		return handle;
+	}
+
+	void BodyStore::Destroy(BodyHandle handle)
+	{
+		if (!IsAlive(handle))
+			return;
+
+		// Leave the awake range first so swapping with the last body keeps both ranges packed
+		uint32_t index = m_Sparse[handle.Index];
+		if (IsAwake(index))
+		{
+			SwapBodies(index, AwakeCount - 1);
+			index = --AwakeCount;
+		}
+
+		SwapBodies(index, Size() - 1);
+
+		Positions.PopBack();
+		PreviousPositions.PopBack();
+		Velocities.PopBack();
+		Forces.PopBack();
+		InverseMasses.pop_back();
+		Types.pop_back();
+		MotionFactors.pop_back();
+		GravityFactors.pop_back();
+		Colliders.pop_back();
+		Shapes.pop_back();
+		OwnerEntityIDs.pop_back();
+		Handles.pop_back();
+		SleepTimers.pop_back();
+		ContinuousCollision.pop_back();
+		Filters.pop_back();
+
+		m_Sparse[handle.Index] = BodyHandle::INVALID_INDEX;
+		m_Generations[handle.Index]++;
+		m_FreeSlots.push_back(handle.Index);
+		Dirty = true;
+		ProxiesDirty = true;
+	}
+
+	void BodyStore::SwapBodies(uint32_t a, uint32_t b)
+	{
+		if (a == b)
+			return;
+
+		Positions.Swap(a, b);
+		PreviousPositions.Swap(a, b);
+		Velocities.Swap(a, b);
+		Forces.Swap(a, b);
+		std::swap(InverseMasses[a], InverseMasses[b]);
+		std::swap(Types[a], Types[b]);
+		std::swap(MotionFactors[a], MotionFactors[b]);
+		std::swap(GravityFactors[a], GravityFactors[b]);
+		std::swap(Colliders[a], Colliders[b]);
+		std::swap(Shapes[a], Shapes[b]);
+		std::swap(OwnerEntityIDs[a], OwnerEntityIDs[b]);
+		std::swap(Handles[a], Handles[b]);
+		std::swap(SleepTimers[a], SleepTimers[b]);
+		std::swap(ContinuousCollision[a], ContinuousCollision[b]);
+		std::swap(Filters[a], Filters[b]);
+
+		m_Sparse[Handles[a].Index] = a;
+		m_Sparse[Handles[b].Index] = b;
+		ProxiesDirty = true;
+	}
+
+	uint32_t BodyStore::Wake(uint32_t index)
+	{
+		if (IsAwake(index) || Types[index] == BodyType::Static)
+			return index;
+
+		SleepTimers[index] = 0.0f;
+		SwapBodies(index, AwakeCount);
+		ProxiesDirty = true;
+		return AwakeCount++;
+	}
+
+	uint32_t BodyStore::Sleep(uint32_t index)
+	{
+		if (!IsAwake(index))
+			return index;
+
+		// Settle in place so waking up does not continue the last motion or interpolate
+		Velocities.Set(index, glm::vec3{0.0f});
+		Forces.Set(index, glm::vec3{0.0f});
+		PreviousPositions.Set(index, Positions.Get(index));
+		SwapBodies(index, --AwakeCount);
+
+		// Refits after a step only cover the awake range, so the last move has to go through a full sync
+		Dirty = true;
+		ProxiesDirty = true;
+		return AwakeCount;
+	}
+
+	void BodyStore::SortByOwner()
+	{
+		SortRange(0, AwakeCount);
+		SortRange(AwakeCount, Size());
+	}
+
+	void BodyStore::SortRange(uint32_t begin, uint32_t end)
+	{
+		auto byOwner = [this](uint32_t a, uint32_t b)
+		{ return OwnerEntityIDs[a] < OwnerEntityIDs[b]; };
+		if (std::is_sorted(OwnerEntityIDs.begin() + begin, OwnerEntityIDs.begin() + end))
+			return;
+
+		const uint32_t count = end - begin;
+		m_Order.resize(count);
+		std::iota(m_Order.begin(), m_Order.end(), begin);
+		std::stable_sort(m_Order.begin(), m_Order.end(), byOwner);
+
+		// Apply the permutation with swaps, tracking where every original body currently is and who sits where
+		m_Locations.resize(count);
+		m_Occupants.resize(count);
+		std::iota(m_Locations.begin(), m_Locations.end(), begin);
+		std::iota(m_Occupants.begin(), m_Occupants.end(), begin);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const uint32_t wanted = m_Order[i];
+			const uint32_t from = m_Locations[wanted - begin];
+			const uint32_t displaced = m_Occupants[i];
+			SwapBodies(begin + i, from);
+
+			m_Occupants[from - begin] = displaced;
+			m_Locations[displaced - begin] = from;
+			m_Occupants[i] = wanted;
+			m_Locations[wanted - begin] = begin + i;
+		}
+	}
+
+	void BodyStore::Clear()
+	{
+		for (const BodyHandle &handle : Handles)
+		{
+			m_Sparse[handle.Index] = BodyHandle::INVALID_INDEX;
+			m_Generations[handle.Index]++;
+			m_FreeSlots.push_back(handle.Index);
+		}
+
+		Positions.Clear();
+		PreviousPositions.Clear();
+		Velocities.Clear();
+		Forces.Clear();
+		InverseMasses.clear();
+		Types.clear();
+		MotionFactors.clear();
+		GravityFactors.clear();
+		Colliders.clear();
+		Shapes.clear();
+		OwnerEntityIDs.clear();
+		Handles.clear();
+		SleepTimers.clear();
+		ContinuousCollision.clear();
+		Filters.clear();
+		AwakeCount = 0;
+		Dirty = true;
+		ProxiesDirty = true;
+	}
+
+	BodyState BodyStore::GetState(uint32_t index) const
+	{
+		BodyState state;
+		state.Position = Positions.Get(index);
+		state.Velocity = Velocities.Get(index);
+		state.Force = Forces.Get(index);
+		state.Mass = InverseMasses[index] > 0.0f ? 1.0f / InverseMasses[index] : 0.0f;
+		state.Type = Types[index];
+		state.BodyCollider = Colliders[index];
+		state.OwnerEntityID = OwnerEntityIDs[index];
+		state.ContinuousCollision = ContinuousCollision[index] != 0;
+		state.Filter = Filters[index];
+		return state;
+	}
+
+	void BodyStore::SetType(uint32_t index, BodyType type)
+	{
+		if (type == BodyType::Static)
+			index = Sleep(index);
+
+		Types[index] = type;
+		MotionFactors[index] = type == BodyType::Static ? 0.0f : 1.0f;
+		GravityFactors[index] = type == BodyType::Dynamic ? 1.0f : 0.0f;
+
+		if (type != BodyType::Static)
+			Wake(index);
+	}
+
+	void BodyStore::SetMass(uint32_t index, float mass)
+	{
+		InverseMasses[index] = mass > 0.0f ? 1.0f / mass : 0.0f;
+	}
+}
@@ -0,0 +1,138 @@
+#ifndef BODYSTORE_H
+#define BODYSTORE_H
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <utility>
+#include <vector>
+
+#include "Body.h"
+#include "Shape.h"
+
+namespace flg
+{
+    // vec3 split into one array per axis so loops over a single axis vectorize
+    struct Vec3Array
+    {
+        std::vector<float> X;
+        std::vector<float> Y;
+        std::vector<float> Z;
+
+        glm::vec3 Get(uint32_t index) const { return glm::vec3{X[index], Y[index], Z[index]}; }
+        void Set(uint32_t index, const glm::vec3 &value)
+        {
+            X[index] = value.x;
+            Y[index] = value.y;
+            Z[index] = value.z;
+        }
+
+        void PushBack(const glm::vec3 &value)
+        {
+            X.push_back(value.x);
+            Y.push_back(value.y);
+            Z.push_back(value.z);
+        }
+
+        void Swap(uint32_t a, uint32_t b)
+        {
+            std::swap(X[a], X[b]);
+            std::swap(Y[a], Y[b]);
+            std::swap(Z[a], Z[b]);
+        }
+
+        void PopBack()
+        {
+            X.pop_back();
+            Y.pop_back();
+            Z.pop_back();
+        }
+
+        void Clear()
+        {
+            X.clear();
+            Y.clear();
+            Z.clear();
+        }
+    };
+
+    // Structure of arrays storage for every body in a world.
+    // Dense arrays stay packed (swap and pop on removal) so the integration loop runs over contiguous memory,
+    // handles map to dense indices through a sparse slot table.
+    // Awake non static bodies are kept in front, [0, AwakeCount), so a step only has to touch that range.
+    class BodyStore
+    {
+    public:
+        BodyHandle Create(const BodyState &state);
+        void Destroy(BodyHandle handle);
+        void Clear();
+
+        bool IsAlive(BodyHandle handle) const
+        {
+            return handle.Index < m_Sparse.size() && m_Generations[handle.Index] == handle.Generation && m_Sparse[handle.Index] != BodyHandle::INVALID_INDEX;
+        }
+
+        // Dense index of a live handle
+        uint32_t IndexOf(BodyHandle handle) const { return m_Sparse[handle.Index]; }
+        uint32_t Size() const { return static_cast<uint32_t>(Handles.size()); }
+
+        BodyState GetState(uint32_t index) const;
+        void SetType(uint32_t index, BodyType type);
+        void SetMass(uint32_t index, float mass);
+
+        // Moving a body between the awake and inactive ranges changes its dense index (and another body's), the new index is returned
+        bool IsAwake(uint32_t index) const { return index < AwakeCount; }
+        uint32_t Wake(uint32_t index);
+        uint32_t Sleep(uint32_t index);
+
+        // Orders the awake and inactive ranges by owner entity ID so the dense layout does not depend on the order
+        // bodies were added, woken or put to sleep in. Bodies sharing an ID keep their relative order.
+        void SortByOwner();
+
+    public:
+        // Dense Arrays
+        Vec3Array Positions;
+        Vec3Array PreviousPositions; // Positions before the last step, for interpolation
+        Vec3Array Velocities;
+        Vec3Array Forces;
+        std::vector<float> InverseMasses;
+        std::vector<BodyType> Types;
+
+        // Integration factors derived from the body type (1 or 0) so the integration loop does not branch
+        std::vector<float> MotionFactors;
+        std::vector<float> GravityFactors;
+
+        std::vector<Collider *> Colliders;
+        std::vector<Shape> Shapes; // Copy of each collider for the narrowphase, refreshed with the broadphase proxies
+        std::vector<uint32_t> OwnerEntityIDs;
+        std::vector<BodyHandle> Handles;          // Dense index -> handle
+        std::vector<float> SleepTimers;           // Seconds spent below the sleep velocity
+        std::vector<uint8_t> ContinuousCollision; // Swept every step regardless of speed
+        std::vector<CollisionFilter> Filters;
+
+        // Bodies before this index are awake and not static
+        uint32_t AwakeCount = 0;
+
+        // Set whenever a body is added, removed or moved, cleared once the world's query tree caught up
+        bool Dirty = true;
+
+        // Set whenever dense indices or the awake range change, cleared once the world's broadphase proxies caught up
+        bool ProxiesDirty = true;
+
+    private:
+        void SwapBodies(uint32_t a, uint32_t b);
+        void SortRange(uint32_t begin, uint32_t end);
+
+    private:
+        std::vector<uint32_t> m_Sparse; // Handle index -> dense index
+        std::vector<uint32_t> m_Generations;
+        std::vector<uint32_t> m_FreeSlots;
+
+        // SortRange scratch
+        std::vector<uint32_t> m_Order;
+        std::vector<uint32_t> m_Locations;
+        std::vector<uint32_t> m_Occupants;
+    };
+}
+
+#endif
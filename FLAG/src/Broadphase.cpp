@@ -0,0 +1,264 @@
+#include "Broadphase.h"
+
+#include <algorithm>
+
+namespace flg
+{
+	std::unique_ptr<Broadphase> Broadphase::CreateBroadphase(BroadphaseType type, float cellSize)
+	{
+		switch (type)
+		{
+		case BroadphaseType::SpatialHash:
+			return std::make_unique<SpatialHashBroadphase>(cellSize);
+		case BroadphaseType::SweepAndPrune:
+			return std::make_unique<SweepAndPruneBroadphase>();
+		case BroadphaseType::BruteForce:
+		default:
+			return std::make_unique<BruteForceBroadphase>();
+		}
+	}
+
+	void Broadphase::FindUnboundedPairs(const std::vector<BroadphaseProxy> &proxies, std::vector<BodyPair> &pairs)
+	{
+		// Duplicates between two unbounded proxies are removed by SortPairs
+		for (uint32_t u : m_Unbounded)
+		{
+			for (uint32_t i = 0; i < static_cast<uint32_t>(proxies.size()); i++)
+			{
+				if (i == u || !proxies[i].Collidable || (!proxies[u].Active && !proxies[i].Active) || !proxies[u].Filter.CanCollide(proxies[i].Filter))
+					continue;
+				if (proxies[u].Bounded && proxies[i].Bounded && !proxies[u].Bounds.Overlaps(proxies[i].Bounds))
+					continue;
+
+				pairs.push_back({std::max(u, i), std::min(u, i)});
+			}
+		}
+	}
+
+	void Broadphase::FindFloorCandidates(const std::vector<BroadphaseProxy> &proxies, uint32_t count, float height, std::vector<uint32_t> &candidates)
+	{
+		candidates.clear();
+		for (uint32_t i = 0; i < count; i++)
+		{
+			if (proxies[i].Bounded && proxies[i].Bounds.Min.y <= height)
+				candidates.push_back(i);
+		}
+	}
+
+	void Broadphase::SortPairs(std::vector<BodyPair> &pairs)
+	{
+		std::sort(pairs.begin(), pairs.end());
+		pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+	}
+
+	// --- Brute Force ---
+	void BruteForceBroadphase::FindPairs(const std::vector<BroadphaseProxy> &proxies, std::vector<BodyPair> &pairs)
+	{
+		pairs.clear();
+
+		// Generated in sorted order
+		for (uint32_t i = 0; i < static_cast<uint32_t>(proxies.size()); i++)
+		{
+			if (!proxies[i].Collidable)
+				continue;
+
+			for (uint32_t j = 0; j < i; j++)
+			{
+				if (proxies[j].Collidable && (proxies[i].Active || proxies[j].Active) && proxies[i].Filter.CanCollide(proxies[j].Filter))
+					pairs.push_back({i, j});
+			}
+		}
+	}
+
+	// --- Spatial Hash ---
+	SpatialHashBroadphase::SpatialHashBroadphase(float cellSize)
+		: m_CellSize(cellSize) {}
+
+	glm::ivec3 SpatialHashBroadphase::ToCell(const glm::vec3 &point) const
+	{
+		// Clamp so far away bodies do not overflow the cast
+		const float limit = static_cast<float>(1 << 30);
+		glm::vec3 cell = glm::clamp(glm::floor(point / m_CellSize), glm::vec3{-limit}, glm::vec3{limit});
+		return glm::ivec3{cell};
+	}
+
+	uint64_t SpatialHashBroadphase::HashCell(const glm::ivec3 &cell)
+	{
+		// 21 bits per axis. Cells that wrap share a key which only adds candidates.
+		const uint64_t mask = (1 << 21) - 1;
+		return ((static_cast<uint64_t>(cell.x) & mask) << 42) |
+			   ((static_cast<uint64_t>(cell.y) & mask) << 21) |
+			   (static_cast<uint64_t>(cell.z) & mask);
+	}
+
+	void SpatialHashBroadphase::FindPairs(const std::vector<BroadphaseProxy> &proxies, std::vector<BodyPair> &pairs)
+	{
+		pairs.clear();
+		m_Cells.clear();
+		m_Inactive.clear();
+		m_Unbounded.clear();
+
+		// Insert active proxies into every cell their bounds touch, inactive proxies only look them up
+		for (uint32_t i = 0; i < static_cast<uint32_t>(proxies.size()); i++)
+		{
+			const BroadphaseProxy &proxy = proxies[i];
+			if (!proxy.Collidable)
+				continue;
+
+			if (!proxy.Bounded)
+			{
+				m_Unbounded.push_back(i);
+				continue;
+			}
+
+			glm::ivec3 minCell = ToCell(proxy.Bounds.Min);
+			glm::ivec3 maxCell = ToCell(proxy.Bounds.Max);
+			glm::i64vec3 extent = glm::i64vec3{maxCell} - glm::i64vec3{minCell} + glm::i64vec3{1};
+			if (extent.x * extent.y * extent.z > MAX_CELLS_PER_PROXY)
+			{
+				m_Unbounded.push_back(i);
+				continue;
+			}
+
+			if (!proxy.Active)
+			{
+				m_Inactive.push_back(i);
+				continue;
+			}
+
+			for (int x = minCell.x; x <= maxCell.x; x++)
+				for (int y = minCell.y; y <= maxCell.y; y++)
+					for (int z = minCell.z; z <= maxCell.z; z++)
+						m_Cells.push_back({HashCell({x, y, z}), i});
+		}
+
+		std::sort(m_Cells.begin(), m_Cells.end());
+
+		// Reports the pair if the bounds overlap and key is the cell holding the minimum corner of the overlap,
+		// so a pair sharing several cells is only reported once
+		auto testPair = [&](uint32_t indexA, uint32_t indexB, uint64_t key)
+		{
+			const BroadphaseProxy &proxyA = proxies[indexA];
+			const BroadphaseProxy &proxyB = proxies[indexB];
+			if (!proxyA.Filter.CanCollide(proxyB.Filter) || !proxyA.Bounds.Overlaps(proxyB.Bounds))
+				return;
+
+			glm::ivec3 ownerCell = ToCell(glm::max(proxyA.Bounds.Min, proxyB.Bounds.Min));
+			if (HashCell(ownerCell) != key)
+				return;
+
+			pairs.push_back({std::max(indexA, indexB), std::min(indexA, indexB)});
+		};
+
+		// Test active proxies sharing a cell
+		size_t runStart = 0;
+		while (runStart < m_Cells.size())
+		{
+			uint64_t key = m_Cells[runStart].Key;
+			size_t runEnd = runStart + 1;
+			while (runEnd < m_Cells.size() && m_Cells[runEnd].Key == key)
+				runEnd++;
+
+			for (size_t a = runStart; a < runEnd; a++)
+			{
+				for (size_t b = a + 1; b < runEnd; b++)
+				{
+					if (m_Cells[a].Proxy != m_Cells[b].Proxy)
+						testPair(m_Cells[a].Proxy, m_Cells[b].Proxy, key);
+				}
+			}
+
+			runStart = runEnd;
+		}
+
+		// Test inactive proxies against the active proxies in their cells, nothing to do once everything sleeps
+		if (!m_Cells.empty())
+		{
+			for (uint32_t i : m_Inactive)
+			{
+				const BroadphaseProxy &proxy = proxies[i];
+				glm::ivec3 minCell = ToCell(proxy.Bounds.Min);
+				glm::ivec3 maxCell = ToCell(proxy.Bounds.Max);
+				for (int x = minCell.x; x <= maxCell.x; x++)
+					for (int y = minCell.y; y <= maxCell.y; y++)
+						for (int z = minCell.z; z <= maxCell.z; z++)
+						{
+							uint64_t key = HashCell({x, y, z});
+							auto entry = std::lower_bound(m_Cells.begin(), m_Cells.end(), CellEntry{key, 0});
+							for (; entry != m_Cells.end() && entry->Key == key; ++entry)
+								testPair(i, entry->Proxy, key);
+						}
+			}
+		}
+
+		FindUnboundedPairs(proxies, pairs);
+		SortPairs(pairs);
+	}
+
+	// --- Sweep And Prune ---
+	void SweepAndPruneBroadphase::FindPairs(const std::vector<BroadphaseProxy> &proxies, std::vector<BodyPair> &pairs)
+	{
+		pairs.clear();
+		m_Unbounded.clear();
+
+		auto compareMinX = [&proxies](uint32_t a, uint32_t b)
+		{ return proxies[a].Bounds.Min.x < proxies[b].Bounds.Min.x; };
+
+		// Rebuild the order when indices were reassigned, otherwise the previous order is nearly sorted
+		if (m_Reordered || m_SortedProxies.size() != proxies.size())
+		{
+			m_Reordered = false;
+			m_SortedProxies.resize(proxies.size());
+			for (uint32_t i = 0; i < static_cast<uint32_t>(proxies.size()); i++)
+				m_SortedProxies[i] = i;
+
+			std::sort(m_SortedProxies.begin(), m_SortedProxies.end(), compareMinX);
+		}
+		else
+		{
+			for (size_t i = 1; i < m_SortedProxies.size(); i++)
+			{
+				uint32_t proxy = m_SortedProxies[i];
+				size_t j = i;
+				while (j > 0 && compareMinX(proxy, m_SortedProxies[j - 1]))
+				{
+					m_SortedProxies[j] = m_SortedProxies[j - 1];
+					j--;
+				}
+				m_SortedProxies[j] = proxy;
+			}
+		}
+
+		// Sweep
+		for (size_t a = 0; a < m_SortedProxies.size(); a++)
+		{
+			uint32_t indexA = m_SortedProxies[a];
+			const BroadphaseProxy &proxyA = proxies[indexA];
+			if (!proxyA.Collidable)
+				continue;
+
+			if (!proxyA.Bounded)
+			{
+				m_Unbounded.push_back(indexA);
+				continue;
+			}
+
+			for (size_t b = a + 1; b < m_SortedProxies.size(); b++)
+			{
+				uint32_t indexB = m_SortedProxies[b];
+				const BroadphaseProxy &proxyB = proxies[indexB];
+				if (proxyB.Bounds.Min.x > proxyA.Bounds.Max.x)
+					break;
+
+				if (!proxyB.Collidable || !proxyB.Bounded || (!proxyA.Active && !proxyB.Active))
+					continue;
+
+				if (proxyA.Filter.CanCollide(proxyB.Filter) && proxyA.Bounds.Overlaps(proxyB.Bounds))
+					pairs.push_back({std::max(indexA, indexB), std::min(indexA, indexB)});
+			}
+		}
+
+		FindUnboundedPairs(proxies, pairs);
+		SortPairs(pairs);
+	}
+}
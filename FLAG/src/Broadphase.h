@@ -0,0 +1,126 @@
+#ifndef BROADPHASE_H
+#define BROADPHASE_H
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+#include "Body.h"
+#include "Collider.h"
+
+namespace flg
+{
+    enum class BroadphaseType
+    {
+        BruteForce = 0,
+        SpatialHash = 1,
+        SweepAndPrune = 2,
+    };
+
+    // Broadphase representation of a body, indexed the same as the world's bodies
+    struct BroadphaseProxy
+    {
+        AABB Bounds;
+        bool Collidable = false; // Has a collider
+        bool Bounded = false;    // False if the collider can not be bounded (tested against every body)
+        bool Active = true;      // Pairs of two inactive (static or sleeping) proxies are skipped
+        CollisionFilter Filter;  // Pairs failing the filter are skipped
+    };
+
+    // Candidate pair of body indices. A is always the later body (A > B) to match the brute force ordering
+    struct BodyPair
+    {
+        uint32_t A;
+        uint32_t B;
+
+        bool operator==(const BodyPair &other) const { return A == other.A && B == other.B; }
+        bool operator<(const BodyPair &other) const { return A < other.A || (A == other.A && B < other.B); }
+    };
+
+    // Produces candidate pairs for the narrowphase, at least one proxy of a pair is active and the filters accept it. Pairs are sorted and unique so every
+    // broadphase hands the narrowphase the same order the brute force path would.
+    class Broadphase
+    {
+    public:
+        virtual ~Broadphase() = default;
+
+        virtual void FindPairs(const std::vector<BroadphaseProxy> &proxies, std::vector<BodyPair> &pairs) = 0;
+        virtual BroadphaseType GetType() const = 0;
+
+        // Called before FindPairs when proxy indices may have been reassigned since the last call (bodies added,
+        // removed, woken or put to sleep), so state kept per index is stale even if the count did not change
+        virtual void OnProxiesReordered() {}
+
+        static std::unique_ptr<Broadphase> CreateBroadphase(BroadphaseType type, float cellSize = 4.0f);
+
+        // Bounded proxies in [0, count) reaching down to a horizontal floor at height, in index order
+        static void FindFloorCandidates(const std::vector<BroadphaseProxy> &proxies, uint32_t count, float height, std::vector<uint32_t> &candidates);
+
+    protected:
+        // Pairs every unbounded proxy with every other collidable proxy, bounded ones (i.e too large for the grid) only where the bounds overlap
+        void FindUnboundedPairs(const std::vector<BroadphaseProxy> &proxies, std::vector<BodyPair> &pairs);
+        static void SortPairs(std::vector<BodyPair> &pairs);
+
+    protected:
+        std::vector<uint32_t> m_Unbounded;
+    };
+
+    // O(n^2) reference implementation
+    class BruteForceBroadphase : public Broadphase
+    {
+    public:
+        virtual void FindPairs(const std::vector<BroadphaseProxy> &proxies, std::vector<BodyPair> &pairs) override;
+        virtual BroadphaseType GetType() const override { return BroadphaseType::BruteForce; }
+    };
+
+    // Uniform grid hashed into a sorted cell list, rebuilt every step from the active proxies
+    class SpatialHashBroadphase : public Broadphase
+    {
+    public:
+        SpatialHashBroadphase(float cellSize);
+
+        virtual void FindPairs(const std::vector<BroadphaseProxy> &proxies, std::vector<BodyPair> &pairs) override;
+        virtual BroadphaseType GetType() const override { return BroadphaseType::SpatialHash; }
+
+        void SetCellSize(float cellSize) { m_CellSize = cellSize; }
+        float GetCellSize() const { return m_CellSize; }
+
+    private:
+        struct CellEntry
+        {
+            uint64_t Key;
+            uint32_t Proxy;
+
+            bool operator<(const CellEntry &other) const { return Key < other.Key || (Key == other.Key && Proxy < other.Proxy); }
+        };
+
+        glm::ivec3 ToCell(const glm::vec3 &point) const;
+        static uint64_t HashCell(const glm::ivec3 &cell);
+
+    private:
+        float m_CellSize;
+        std::vector<CellEntry> m_Cells;   // Active proxies only
+        std::vector<uint32_t> m_Inactive; // Bounded inactive proxies
+
+        // Proxies spanning more cells than this are handled as unbounded
+        static const uint32_t MAX_CELLS_PER_PROXY = 64;
+    };
+
+    // Sort and sweep along the x axis. The sorted order is kept between steps so
+    // mostly coherent scenes only pay for an insertion sort.
+    class SweepAndPruneBroadphase : public Broadphase
+    {
+    public:
+        virtual void FindPairs(const std::vector<BroadphaseProxy> &proxies, std::vector<BodyPair> &pairs) override;
+        virtual BroadphaseType GetType() const override { return BroadphaseType::SweepAndPrune; }
+        virtual void OnProxiesReordered() override { m_Reordered = true; }
+
+    private:
+        std::vector<uint32_t> m_SortedProxies;
+        bool m_Reordered = true; // Swapped indices can be far from their sorted slot, a full sort beats the insertion sort
+    };
+}
+
+#endif
@@ -1,21 +1,33 @@
 #include "Collider.h"
 #include "Algorithms.h"
+#include "Shape.h"
 
 namespace flg
 {
 	PlaneCollider::PlaneCollider(glm::vec3 origin, glm::vec3 normal, glm::vec3 bounds)
-		: Origin(origin), Normal(normal), Bounds(bounds) {}
+		: Origin(origin), Normal(normal), Bounds(bounds) { Type = ColliderType::Plane; }
 	PlaneCollider::PlaneCollider()
-		: Origin(0.0f), Normal(0.0f), Bounds(0.0f) {}
+		: Origin(0.0f), Normal(0.0f), Bounds(0.0f) { Type = ColliderType::Plane; }
+
+	bool PlaneCollider::ComputeAABB(const Transform *transform, AABB &aabb) const
+	{
+		return ComputeShapeAABB(Shape::FromCollider(this), transform->Position, aabb);
+	}
+
+	// Colliders of unknown type go through the shape dispatch table, a plain table lookup instead of a second virtual call
+	static CollisionPoints TestColliders(const Collider *a, const Transform *transformA, const Collider *b, const Transform *transformB)
+	{
+		const glm::vec3 positionA = transformA ? transformA->Position : glm::vec3{0.0f};
+		const glm::vec3 positionB = transformB ? transformB->Position : glm::vec3{0.0f};
+		return TestShapeCollision(Shape::FromCollider(a), positionA, Shape::FromCollider(b), positionB);
+	}
 
 	CollisionPoints PlaneCollider::TestCollision(
 		const Transform *transform,
 		const Collider *collider,
 		const Transform *colliderTransform) const
 	{
-		// Double dispatch to resolve both collider types.
-		// i.e collider->specific_collider->TestCollision(transform, PlaneCollider, PlaneTransform);
-		return collider->TestCollision(colliderTransform, this, transform);
+		return TestColliders(this, transform, collider, colliderTransform);
 	};
 
 	CollisionPoints PlaneCollider::TestCollision(
@@ -23,7 +35,7 @@ namespace flg
 		const SphereCollider *collider,
 		const Transform *colliderTransform) const
 	{
-		return CollisionPoints{};
+		return algo::FindPlaneSphereCollissionPoints(this, transform, collider, colliderTransform);
 	};
 
 	CollisionPoints PlaneCollider::TestCollision(
@@ -43,16 +55,24 @@ namespace flg
 	}
 
 	SphereCollider::SphereCollider(glm::vec3 center, float radius)
-		: Center(center), Radius(radius) {}
+		: Center(center), Radius(radius) { Type = ColliderType::Sphere; }
 	SphereCollider::SphereCollider()
-		: Center(0.0f), Radius(1.0f) {}
+		: Center(0.0f), Radius(1.0f) { Type = ColliderType::Sphere; }
+
+	bool SphereCollider::ComputeAABB(const Transform *transform, AABB &aabb) const
+	{
+		glm::vec3 worldCenter = transform->Position + Center;
+		aabb.Min = worldCenter - glm::vec3{Radius};
+		aabb.Max = worldCenter + glm::vec3{Radius};
+		return true;
+	}
 
 	CollisionPoints SphereCollider::TestCollision(
 		const Transform *transform,
 		const Collider *collider,
 		const Transform *colliderTransform) const
 	{
-		return collider->TestCollision(colliderTransform, this, transform);
+		return TestColliders(this, transform, collider, colliderTransform);
 	};
 
 	CollisionPoints SphereCollider::TestCollision(
@@ -68,7 +88,7 @@ namespace flg
 		const PlaneCollider *collider,
 		const Transform *colliderTransform) const
 	{
-		return CollisionPoints{};
+		return algo::FindSpherePlaneCollissionPoints(this, transform, collider, colliderTransform);
 	};
 
 	CollisionPoints SphereCollider::TestCollision(
@@ -80,14 +100,14 @@ namespace flg
 	};
 
 	Ray::Ray(const glm::vec3 origin, const glm::vec3 direction)
-		: Origin(origin), Direction(direction) {}
+		: Origin(origin), Direction(direction) { Type = ColliderType::Ray; }
 
 	CollisionPoints Ray::TestCollision(
 		const Transform *transform,
 		const Collider *collider,
 		const Transform *colliderTransform) const
 	{
-		return collider->TestCollision(colliderTransform, this, transform);
+		return TestColliders(this, transform, collider, colliderTransform);
 	};
 
 	CollisionPoints Ray::TestCollision(
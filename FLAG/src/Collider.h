@@ -28,14 +28,58 @@ namespace flg
         bool DidCollide = false;
     };
 
+    // Axis aligned bounding box in world space
+    struct AABB
+    {
+        glm::vec3 Min{0.0f};
+        glm::vec3 Max{0.0f};
+
+        bool Overlaps(const AABB &other) const
+        {
+            return Min.x <= other.Max.x && Max.x >= other.Min.x &&
+                   Min.y <= other.Max.y && Max.y >= other.Min.y &&
+                   Min.z <= other.Max.z && Max.z >= other.Min.z;
+        }
+
+        bool Contains(const AABB &other) const
+        {
+            return Min.x <= other.Min.x && Min.y <= other.Min.y && Min.z <= other.Min.z &&
+                   Max.x >= other.Max.x && Max.y >= other.Max.y && Max.z >= other.Max.z;
+        }
+
+        static AABB Merge(const AABB &a, const AABB &b) { return AABB{glm::min(a.Min, b.Min), glm::max(a.Max, b.Max)}; }
+
+        // Cost metric used to build trees
+        float SurfaceArea() const
+        {
+            glm::vec3 size = Max - Min;
+            return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+        }
+    };
+
     // Forward declare colliders/collidable objects
     struct SphereCollider;
     struct PlaneCollider;
     struct Ray;
     struct Transform;
 
+    enum class ColliderType
+    {
+        None = 0,
+        Sphere = 1,
+        Plane = 2,
+        Ray = 3,
+    };
+
     struct Collider
     {
+        // Lets hot paths pick batched kernels without a virtual call
+        ColliderType Type = ColliderType::None;
+
+        // Returns false if the collider has no finite bounds (i.e may collide with anything)
+        virtual bool ComputeAABB(const Transform *transform, AABB &aabb) const { return false; }
+
+        // Subclasses resolve the other collider's type through the shape dispatch table (see Shape.h)
         virtual CollisionPoints TestCollision(
             const Transform *transform,
             const Collider *collider,
@@ -62,11 +106,14 @@ namespace flg
     public:
         glm::vec3 Origin;
         glm::vec3 Normal;
-        glm::vec2 Bounds;
+        glm::vec2 Bounds; // Half extents along the plane's tangents (x and z for a horizontal plane), 0 is unbounded
 
         PlaneCollider(glm::vec3 origin, glm::vec3 normal, glm::vec3 bounds);
         PlaneCollider();
 
+        // Bounded only if both half extents are set
+        virtual bool ComputeAABB(const Transform *transform, AABB &aabb) const override;
+
         virtual CollisionPoints TestCollision(
             const Transform *transform,
             const Collider *collider,
@@ -97,6 +144,8 @@ namespace flg
         SphereCollider(glm::vec3 center, float radius);
         SphereCollider();
 
+        virtual bool ComputeAABB(const Transform *transform, AABB &aabb) const override;
+
         virtual CollisionPoints TestCollision(
             const Transform *transform,
             const Collider *collider,
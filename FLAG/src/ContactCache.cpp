@@ -0,0 +1,75 @@
+#include "ContactCache.h"
+#include "BodyStore.h"
+
+#include <algorithm>
+
+namespace flg
+{
+	uint64_t ContactCache::MakeKey(BodyHandle a, BodyHandle b)
+	{
+		uint64_t low = std::min(a.Index, b.Index);
+		uint64_t high = std::max(a.Index, b.Index);
+		return (low << 32) | high;
+	}
+
+	void ContactCache::Update(std::vector<Contact> &contacts, std::vector<ContactTransition> &transitions, const BodyStore &bodies)
+	{
+		std::sort(contacts.begin(), contacts.end());
+
+		m_Previous.swap(m_Contacts);
+		m_Contacts.swap(contacts);
+		contacts.clear();
+		transitions.clear();
+
+		auto exit = [&](uint32_t previous)
+		{
+			const Contact &contact = m_Previous[previous];
+			if (bodies.IsAlive(contact.A) && bodies.IsAlive(contact.B))
+				transitions.push_back({ContactState::Exit, previous});
+		};
+
+		// Merge walk, keys only in the new list entered and keys only in the old list exited
+		uint32_t current = 0;
+		uint32_t previous = 0;
+		const uint32_t currentCount = static_cast<uint32_t>(m_Contacts.size());
+		const uint32_t previousCount = static_cast<uint32_t>(m_Previous.size());
+		while (current < currentCount || previous < previousCount)
+		{
+			if (previous == previousCount || (current < currentCount && m_Contacts[current].Key < m_Previous[previous].Key))
+			{
+				transitions.push_back({ContactState::Enter, current++});
+			}
+			else if (current == currentCount || m_Previous[previous].Key < m_Contacts[current].Key)
+			{
+				exit(previous++);
+			}
+			else
+			{
+				// Same slots but a reused handle is a different pair
+				const Contact &now = m_Contacts[current];
+				const Contact &before = m_Previous[previous];
+				bool samePair = (now.A == before.A && now.B == before.B) || (now.A == before.B && now.B == before.A);
+				if (samePair)
+				{
+					m_Contacts[current].NormalImpulse = before.NormalImpulse;
+					m_Contacts[current].TangentImpulse = before.TangentImpulse;
+					transitions.push_back({ContactState::Stay, current});
+				}
+				else
+				{
+					exit(previous);
+					transitions.push_back({ContactState::Enter, current});
+				}
+
+				current++;
+				previous++;
+			}
+		}
+	}
+
+	void ContactCache::Clear()
+	{
+		m_Contacts.clear();
+		m_Previous.clear();
+	}
+}
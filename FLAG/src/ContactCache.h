@@ -0,0 +1,69 @@
+#ifndef CONTACTCACHE_H
+#define CONTACTCACHE_H
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Body.h"
+#include "Collider.h"
+
+namespace flg
+{
+    class BodyStore;
+
+    enum class ContactState
+    {
+        Enter = 0,
+        Stay = 1,
+        Exit = 2,
+    };
+
+    // Pair of touching bodies, keyed by both handles so it survives bodies moving around in the store
+    struct Contact
+    {
+        uint64_t Key = 0;
+        BodyHandle A;
+        BodyHandle B;
+        uint32_t EntityA = -1;
+        uint32_t EntityB = -1;
+        CollisionPoints Points;
+
+        // Solver impulses accumulated over the last step, carried over while the pair stays in contact to warm start the next
+        float NormalImpulse = 0.0f;
+        glm::vec3 TangentImpulse{0.0f};
+        uint32_t Order = -1; // Position among the pairs tested this step, -1 for contacts carried over between inactive bodies
+
+        bool operator<(const Contact &other) const { return Key < other.Key; }
+    };
+
+    struct ContactTransition
+    {
+        ContactState State;
+        uint32_t Index; // Into GetContacts for Enter and Stay, into GetPreviousContacts for Exit
+    };
+
+    // Contacts of the last step, compared against the next step's contacts to find enter, stay and exit transitions.
+    // Both lists are kept sorted by key so the comparison is a single merge walk.
+    class ContactCache
+    {
+    public:
+        static uint64_t MakeKey(BodyHandle a, BodyHandle b);
+
+        // Swaps in this step's contacts (left holding the old ones) and lists the transitions in key order.
+        // Contacts whose bodies were removed from the store leave without an Exit transition.
+        void Update(std::vector<Contact> &contacts, std::vector<ContactTransition> &transitions, const BodyStore &bodies);
+        void Clear();
+
+        const std::vector<Contact> &GetContacts() const { return m_Contacts; }
+        std::vector<Contact> &GetContacts() { return m_Contacts; }
+        const std::vector<Contact> &GetPreviousContacts() const { return m_Previous; }
+
+    private:
+        std::vector<Contact> m_Contacts;
+        std::vector<Contact> m_Previous;
+    };
+}
+
+#endif
@@ -1,105 +1,1133 @@
 #include "Physics.h"
+#include "Algorithms.h"
+#include "Replay.h"
+
+#include <algorithm>
+#include <cstring>
 
 namespace flg
 {
-	// Bodies
-	std::vector<Body *> PhysicsWorld::m_Bodies{};
-	PhysicsWorldProperties PhysicsWorld::m_Properties{};
-
-	// Default Callbacks
-	std::function<void(CollisionPoints &col, uint32_t entityA, uint32_t entityB)> PhysicsWorld::m_CollisionEnterCallback = [](CollisionPoints, uint32_t, uint32_t) {};
-	std::function<void(CollisionPoints &col, uint32_t entityA, uint32_t entityB)> PhysicsWorld::m_CollisionExitCallback = [](CollisionPoints, uint32_t, uint32_t) {};
+	PhysicsWorld::PhysicsWorld(const PhysicsWorldProperties &properties)
+		: m_Properties(properties),
+		  m_Broadphase(Broadphase::CreateBroadphase(properties.Broadphase, properties.SpatialHashCellSize)),
+		  m_Workers(std::make_unique<WorkerPool>(properties.ThreadCount)),
+		  m_Scratch(m_Workers->GetThreadCount())
+	{
+	}
 
 	PhysicsWorld::~PhysicsWorld()
 	{
-		m_Bodies.clear();
+		m_Bodies.Clear();
 	}
 
 	void PhysicsWorld::Step(float dt)
 	{
+		if (m_Properties.Deterministic)
+		{
+			dt = m_Properties.FixedTimeStep;
+			m_Bodies.SortByOwner();
+		}
+
+		if (m_Recording)
+			m_Recording->BeginStep(m_Bodies, dt);
+
+		// Sleeping bodies do not move and already have their previous position
+		const uint32_t awakeCount = m_Bodies.AwakeCount;
+		std::copy_n(m_Bodies.Positions.X.begin(), awakeCount, m_Bodies.PreviousPositions.X.begin());
+		std::copy_n(m_Bodies.Positions.Y.begin(), awakeCount, m_Bodies.PreviousPositions.Y.begin());
+		std::copy_n(m_Bodies.Positions.Z.begin(), awakeCount, m_Bodies.PreviousPositions.Z.begin());
+		m_QueryTreeStale = true;
+
 		ResolveCollision(dt);
+		IntegrateVelocities(dt);
+		SolveContacts(dt);
+		IntegratePositions(dt);
+		SweepFastBodies();
+		UpdateSleeping();
+
+		if (m_Properties.Deterministic || m_Recording)
+			m_StepHash = ComputeStateHash();
+		if (m_Recording)
+			m_Recording->EndStep(m_Bodies, m_StepHash);
+	}
+
+	// Per body so the sum does not depend on the dense order
+	static uint64_t HashBody(uint64_t hash, const float *values, uint32_t count)
+	{
+		for (uint32_t i = 0; i < count; i++)
+		{
+			uint32_t bits;
+			std::memcpy(&bits, &values[i], sizeof(bits));
+			hash = (hash ^ bits) * 0x100000001B3ull; // FNV-1a
+		}
+
+		// splitmix64 finalizer, spreads every input bit over the whole hash before summing
+		hash ^= hash >> 30;
+		hash *= 0xBF58476D1CE4E5B9ull;
+		hash ^= hash >> 27;
+		hash *= 0x94D049BB133111EBull;
+		return hash ^ (hash >> 31);
+	}
+
+	uint64_t PhysicsWorld::ComputeStateHash() const
+	{
+		uint64_t sum = m_Bodies.Size();
+		for (uint32_t i = 0; i < m_Bodies.Size(); i++)
+		{
+			const float values[6] = {m_Bodies.Positions.X[i], m_Bodies.Positions.Y[i], m_Bodies.Positions.Z[i],
+									 m_Bodies.Velocities.X[i], m_Bodies.Velocities.Y[i], m_Bodies.Velocities.Z[i]};
+			sum += HashBody((0xCBF29CE484222325ull ^ m_Bodies.OwnerEntityIDs[i]) * 0x100000001B3ull, values, 6);
+		}
+		return sum;
+	}
+
+	void PhysicsWorld::StartRecording(PhysicsRecording *recording)
+	{
+		m_Properties.Deterministic = true;
+		recording->Clear();
+		recording->Properties = m_Properties;
+		m_Recording = recording;
+	}
+
+	void PhysicsWorld::SetProperties(const PhysicsWorldProperties &properties)
+	{
+		const PhysicsWorldProperties previous = m_Properties;
+		m_Properties = properties;
+
+		if (previous.Broadphase != properties.Broadphase || previous.SpatialHashCellSize != properties.SpatialHashCellSize)
+			m_Broadphase = Broadphase::CreateBroadphase(properties.Broadphase, properties.SpatialHashCellSize);
+		if (previous.ThreadCount != properties.ThreadCount)
+			SetThreadCount(properties.ThreadCount);
+		if (previous.FixedTimeStep != properties.FixedTimeStep)
+			m_Accumulator = 0.0f;
+		if (!properties.AllowSleeping)
+			SetAllowSleeping(false);
+	}
+
+	uint32_t PhysicsWorld::Advance(float frameTime)
+	{
+		const float step = m_Properties.FixedTimeStep;
+		m_Accumulator += std::max(frameTime, 0.0f);
+
+		uint32_t steps = 0;
+		while (m_Accumulator >= step && steps < m_Properties.MaxSubSteps)
+		{
+			Step(step);
+			m_Accumulator -= step;
+			steps++;
+		}
+
+		// Drop time the step cap could not catch up on instead of spiralling on the next frames
+		m_Accumulator = std::min(m_Accumulator, step * 0.999f);
+		return steps;
+	}
+
+	// Work below these sizes is not worth waking the workers for
+	static constexpr uint32_t INTEGRATE_RANGE = 1024;
+	static constexpr uint32_t PROXY_RANGE = 1024;
+	static constexpr uint32_t PAIR_CHUNK = 256;
+
+	// Integrates one velocity axis of every body. Static bodies have a motion factor of 0, only dynamic bodies have a gravity factor of 1
+	static void IntegrateVelocityAxis(uint32_t count, float dt, float gravity, float *__restrict velocities, float *__restrict forces,
+									  const float *__restrict inverseMasses, const float *__restrict motionFactors, const float *__restrict gravityFactors)
+	{
+		for (uint32_t i = 0; i < count; i++)
+		{
+			float step = motionFactors[i] * dt;
+			velocities[i] += (forces[i] * inverseMasses[i] + gravity * gravityFactors[i]) * step;
+			forces[i] = 0.0f;
+		}
+	}
+
+	static void IntegratePositionAxis(uint32_t count, float dt, float *__restrict positions, const float *__restrict velocities, const float *__restrict motionFactors)
+	{
+		for (uint32_t i = 0; i < count; i++)
+			positions[i] += velocities[i] * (motionFactors[i] * dt);
+	}
+
+	void PhysicsWorld::IntegrateVelocities(float dt)
+	{
+		const glm::vec3 gravity = m_Properties.Gravity;
+
+		// Bodies are independent so each range integrates on its own, only the awake range moves
+		m_Workers->ParallelFor(m_Bodies.AwakeCount, INTEGRATE_RANGE, [this, dt, gravity](uint32_t begin, uint32_t end, uint32_t)
+							   {
+			const uint32_t count = end - begin;
+			const float *inverseMasses = m_Bodies.InverseMasses.data() + begin;
+			const float *motionFactors = m_Bodies.MotionFactors.data() + begin;
+			const float *gravityFactors = m_Bodies.GravityFactors.data() + begin;
+
+			IntegrateVelocityAxis(count, dt, gravity.x, m_Bodies.Velocities.X.data() + begin, m_Bodies.Forces.X.data() + begin, inverseMasses, motionFactors, gravityFactors);
+			IntegrateVelocityAxis(count, dt, gravity.y, m_Bodies.Velocities.Y.data() + begin, m_Bodies.Forces.Y.data() + begin, inverseMasses, motionFactors, gravityFactors);
+			IntegrateVelocityAxis(count, dt, gravity.z, m_Bodies.Velocities.Z.data() + begin, m_Bodies.Forces.Z.data() + begin, inverseMasses, motionFactors, gravityFactors); });
+	}
+
+	void PhysicsWorld::IntegratePositions(float dt)
+	{
+		const float sleepVelocitySquared = m_Properties.SleepVelocity * m_Properties.SleepVelocity;
+
+		m_Workers->ParallelFor(m_Bodies.AwakeCount, INTEGRATE_RANGE, [this, dt, sleepVelocitySquared](uint32_t begin, uint32_t end, uint32_t)
+							   {
+			const uint32_t count = end - begin;
+			const float *motionFactors = m_Bodies.MotionFactors.data() + begin;
+
+			IntegratePositionAxis(count, dt, m_Bodies.Positions.X.data() + begin, m_Bodies.Velocities.X.data() + begin, motionFactors);
+			IntegratePositionAxis(count, dt, m_Bodies.Positions.Y.data() + begin, m_Bodies.Velocities.Y.data() + begin, motionFactors);
+			IntegratePositionAxis(count, dt, m_Bodies.Positions.Z.data() + begin, m_Bodies.Velocities.Z.data() + begin, motionFactors);
+
+			// Time spent resting, read by UpdateSleeping
+			const float *velocitiesX = m_Bodies.Velocities.X.data() + begin;
+			const float *velocitiesY = m_Bodies.Velocities.Y.data() + begin;
+			const float *velocitiesZ = m_Bodies.Velocities.Z.data() + begin;
+			float *sleepTimers = m_Bodies.SleepTimers.data() + begin;
+			for (uint32_t i = 0; i < count; i++)
+			{
+				float speedSquared = velocitiesX[i] * velocitiesX[i] + velocitiesY[i] * velocitiesY[i] + velocitiesZ[i] * velocitiesZ[i];
+				sleepTimers[i] = speedSquared < sleepVelocitySquared ? sleepTimers[i] + dt : 0.0f;
+			} });
+	}
+
+	// Sequential impulse step of one constraint, the caller writes the velocities back
+	void PhysicsWorld::ApplyContactImpulses(ContactConstraint &constraint, glm::vec3 &velocityA, glm::vec3 &velocityB, float friction)
+	{
+		// Normal, accumulated impulse never pulls the bodies together
+		float normalVelocity = glm::dot(velocityB - velocityA, constraint.Normal);
+		float previousImpulse = constraint.NormalImpulse;
+		constraint.NormalImpulse = std::max(previousImpulse + (constraint.Bias - normalVelocity) * constraint.NormalMass, 0.0f);
+		glm::vec3 impulse = (constraint.NormalImpulse - previousImpulse) * constraint.Normal;
+		velocityA -= constraint.InverseMassA * impulse;
+		velocityB += constraint.InverseMassB * impulse;
+
+		// Friction, stops the sliding velocity within the cone of the normal impulse
+		glm::vec3 relativeVelocity = velocityB - velocityA;
+		glm::vec3 slidingVelocity = relativeVelocity - glm::dot(relativeVelocity, constraint.Normal) * constraint.Normal;
+		glm::vec3 previousTangent = constraint.TangentImpulse;
+		glm::vec3 tangentImpulse = previousTangent - slidingVelocity * constraint.NormalMass;
+		float maxFriction = friction * constraint.NormalImpulse;
+		float tangentLength = glm::length(tangentImpulse);
+		if (tangentLength > maxFriction)
+			tangentImpulse *= maxFriction / tangentLength;
+		constraint.TangentImpulse = tangentImpulse;
+
+		impulse = tangentImpulse - previousTangent;
+		velocityA -= constraint.InverseMassA * impulse;
+		velocityB += constraint.InverseMassB * impulse;
+	}
+
+	Shape PhysicsWorld::GetFloorShape()
+	{
+		Shape floor;
+		floor.Type = ColliderType::Plane;
+		floor.Plane = PlaneShape{glm::vec3{0.0f, m_Properties.WorldFloorHeight, 0.0f}, glm::vec3{0.0f, 1.0f, 0.0f}, glm::vec2{0.0f}};
+		return floor;
+	}
 
-		for (Body *body : m_Bodies)
+	void PhysicsWorld::SolveContacts(float dt)
+	{
+		m_Constraints.clear();
+		m_FloorConstraints.clear();
+		const uint32_t iterations = m_Properties.SolverIterations;
+		if (iterations == 0 || dt <= 0.0f)
+			return;
+
+		// Callbacks ran since the contacts were found, so bodies are looked up again through their handles.
+		// Only awake dynamic bodies respond, everything else acts as an immovable wall this step.
+		auto responseInverseMass = [this](uint32_t index)
+		{ return m_Bodies.IsAwake(index) && m_Bodies.Types[index] == BodyType::Dynamic ? m_Bodies.InverseMasses[index] : 0.0f; };
+
+		const float restitution = m_Properties.Restitution;
+		const float biasFactor = m_Properties.Baumgarte / dt;
+		const float slop = m_Properties.PenetrationSlop;
+		auto prepare = [&](ContactConstraint &constraint, Contact &contact, const Shape &shapeB, const glm::vec3 &positionB, const glm::vec3 &velocityB)
 		{
-			if (body->Type == BodyType::Static)
+			float depth;
+			const float inverseMassSum = constraint.InverseMassA + constraint.InverseMassB;
+			if (inverseMassSum == 0.0f || !ComputeShapeContact(m_Bodies.Shapes[constraint.A], m_Bodies.Positions.Get(constraint.A), shapeB, positionB, constraint.Normal, depth))
+			{
+				contact.NormalImpulse = 0.0f;
+				contact.TangentImpulse = glm::vec3{0.0f};
+				return false;
+			}
+
+			// Push out the penetration over a few steps, or bounce if the bodies approach faster than that
+			const float approach = glm::dot(velocityB - m_Bodies.Velocities.Get(constraint.A), constraint.Normal);
+			constraint.NormalMass = 1.0f / inverseMassSum;
+			constraint.Bias = std::max(biasFactor * std::max(depth - slop, 0.0f), -restitution * approach);
+
+			// Warm start with last step's impulses, dropping the part of the friction that now points along the normal
+			constraint.NormalImpulse = contact.NormalImpulse;
+			constraint.TangentImpulse = contact.TangentImpulse - glm::dot(contact.TangentImpulse, constraint.Normal) * constraint.Normal;
+			return true;
+		};
+
+		std::vector<Contact> &contacts = m_ContactCache.GetContacts();
+		for (uint32_t contactIndex : m_SolverContacts)
+		{
+			Contact &contact = contacts[contactIndex];
+			if (!m_Bodies.IsAlive(contact.A) || !m_Bodies.IsAlive(contact.B))
 				continue;
 
-			if (body->Type == BodyType::Dynamic)
-				body->Force += body->Mass * m_Properties.Gravity;
+			ContactConstraint constraint;
+			constraint.A = m_Bodies.IndexOf(contact.A);
+			constraint.B = m_Bodies.IndexOf(contact.B);
+			constraint.Contact = contactIndex;
+			constraint.InverseMassA = responseInverseMass(constraint.A);
+			constraint.InverseMassB = responseInverseMass(constraint.B);
+			if (!prepare(constraint, contact, m_Bodies.Shapes[constraint.B], m_Bodies.Positions.Get(constraint.B), m_Bodies.Velocities.Get(constraint.B)))
+				continue;
 
-			body->Velocity += (body->Force / body->Mass) * dt;
-			body->BodyTransform.Position += body->Velocity * dt;
+			const glm::vec3 impulse = constraint.NormalImpulse * constraint.Normal + constraint.TangentImpulse;
+			m_Bodies.Velocities.Set(constraint.A, m_Bodies.Velocities.Get(constraint.A) - constraint.InverseMassA * impulse);
+			m_Bodies.Velocities.Set(constraint.B, m_Bodies.Velocities.Get(constraint.B) + constraint.InverseMassB * impulse);
+			m_Constraints.push_back(constraint);
+		}
 
-			// TODO: Add World Floor In Properties
-			body->BodyTransform.Position.y = std::max(body->BodyTransform.Position.y, 1.4f);
+		// The floor is B of its contacts, immovable and not part of the store
+		const Shape floor = GetFloorShape();
+		std::vector<Contact> &floorContacts = m_FloorContactCache.GetContacts();
+		for (uint32_t contactIndex : m_FloorSolverContacts)
+		{
+			Contact &contact = floorContacts[contactIndex];
+			if (!m_Bodies.IsAlive(contact.A))
+				continue;
 
-			body->Force = glm::vec3{0.0f};
+			ContactConstraint constraint;
+			constraint.A = m_Bodies.IndexOf(contact.A);
+			constraint.B = BodyHandle::INVALID_INDEX;
+			constraint.Contact = contactIndex;
+			constraint.InverseMassA = responseInverseMass(constraint.A);
+			constraint.InverseMassB = 0.0f;
+			if (!prepare(constraint, contact, floor, glm::vec3{0.0f}, glm::vec3{0.0f}))
+				continue;
+
+			const glm::vec3 impulse = constraint.NormalImpulse * constraint.Normal + constraint.TangentImpulse;
+			m_Bodies.Velocities.Set(constraint.A, m_Bodies.Velocities.Get(constraint.A) - constraint.InverseMassA * impulse);
+			m_FloorConstraints.push_back(constraint);
+		}
+
+		// Sequential impulses, every constraint sees the velocities the previous ones left behind. The floor goes last so
+		// it has the final say over what gets pushed into it.
+		const float friction = m_Properties.Friction;
+		for (uint32_t iteration = 0; iteration < iterations; iteration++)
+		{
+			for (ContactConstraint &constraint : m_Constraints)
+			{
+				glm::vec3 velocityA = m_Bodies.Velocities.Get(constraint.A);
+				glm::vec3 velocityB = m_Bodies.Velocities.Get(constraint.B);
+				ApplyContactImpulses(constraint, velocityA, velocityB, friction);
+				m_Bodies.Velocities.Set(constraint.A, velocityA);
+				m_Bodies.Velocities.Set(constraint.B, velocityB);
+			}
+
+			for (ContactConstraint &constraint : m_FloorConstraints)
+			{
+				glm::vec3 velocityA = m_Bodies.Velocities.Get(constraint.A);
+				glm::vec3 velocityB{0.0f};
+				ApplyContactImpulses(constraint, velocityA, velocityB, friction);
+				m_Bodies.Velocities.Set(constraint.A, velocityA);
+			}
+		}
+
+		for (const ContactConstraint &constraint : m_Constraints)
+		{
+			contacts[constraint.Contact].NormalImpulse = constraint.NormalImpulse;
+			contacts[constraint.Contact].TangentImpulse = constraint.TangentImpulse;
+		}
+		for (const ContactConstraint &constraint : m_FloorConstraints)
+		{
+			floorContacts[constraint.Contact].NormalImpulse = constraint.NormalImpulse;
+			floorContacts[constraint.Contact].TangentImpulse = constraint.TangentImpulse;
 		}
 	}
 
-	PhysicsWorld::Raycasthit PhysicsWorld::Raycast(const Ray *ray, float distance)
+	void PhysicsWorld::SweepFastBodies()
 	{
-		Raycasthit hit = Raycasthit();
+		if (!m_Properties.ContinuousCollision)
+			return;
+
+		// Only bodies that moved far enough to skip past something are swept, so resting and slow bodies cost a length check
+		m_SweptBodies.clear();
+		const float threshold = m_Properties.ContinuousThreshold;
+		for (uint32_t i = 0; i < m_Bodies.AwakeCount; i++)
+		{
+			const Shape &shape = m_Bodies.Shapes[i];
+			if (shape.Type != ColliderType::Sphere || m_Bodies.Types[i] != BodyType::Dynamic)
+				continue;
 
-		for (Body *body : m_Bodies)
+			glm::vec3 motion = m_Bodies.Positions.Get(i) - m_Bodies.PreviousPositions.Get(i);
+			float limit = threshold * shape.Sphere.Radius;
+			if (m_Bodies.ContinuousCollision[i] || glm::dot(motion, motion) > limit * limit)
+				m_SweptBodies.push_back(i);
+		}
+
+		if (m_SweptBodies.empty())
+			return;
+
+		SyncQueryTree();
+		const Shape floor = GetFloorShape();
+		const float restitution = m_Properties.Restitution;
+		for (uint32_t i : m_SweptBodies)
 		{
-			if (body->BodyCollider != nullptr)
-			{ // Check Collision
-				Transform *t = &body->BodyTransform;
-				CollisionPoints col = body->BodyCollider->TestCollision(t, ray, nullptr);
+			const Shape &shape = m_Bodies.Shapes[i];
+			const CollisionFilter filter = m_Bodies.Filters[i];
+			const glm::vec3 start = m_Bodies.PreviousPositions.Get(i);
+			const glm::vec3 motion = m_Bodies.Positions.Get(i) - start;
 
-				if (col.DidCollide)
+			// Earliest hit, ties go to the lowest dense index so the result does not depend on the tree layout
+			float nearestT = 2.0f;
+			uint32_t nearest = BodyHandle::INVALID_INDEX;
+			glm::vec3 nearestNormal{0.0f};
+			auto sweep = [&](const Shape &other, const glm::vec3 &otherPosition, uint32_t index)
+			{
+				float t;
+				glm::vec3 normal;
+				if (index == i || !SweepShape(shape, start, motion, other, otherPosition, t, normal))
+					return;
+				if (t < nearestT || (t == nearestT && index < nearest))
 				{
-					hit.CollisionPoint = col.A;
-					hit.body = body;
-					// TODO: CHANGE FROM FIRST HIT TO ALL HIT
-					break;
+					nearestT = t;
+					nearest = index;
+					nearestNormal = normal;
 				}
+			};
+
+			AABB startBounds, endBounds;
+			ComputeShapeAABB(shape, start, startBounds);
+			ComputeShapeAABB(shape, start + motion, endBounds);
+			m_QueryTree.QueryAABB(AABB::Merge(startBounds, endBounds), [&](int32_t proxy)
+								  {
+				uint32_t index = QueryBodyIndex(m_QueryTree.GetUserData(proxy));
+				if (filter.CanCollide(m_Bodies.Filters[index]))
+					sweep(m_Bodies.Shapes[index], m_Bodies.Positions.Get(index), index);
+				return true; });
+			for (uint32_t slot : m_UnboundedBodies)
+			{
+				uint32_t index = QueryBodyIndex(slot);
+				if (filter.CanCollide(m_Bodies.Filters[index]))
+					sweep(m_Bodies.Shapes[index], m_Bodies.Positions.Get(index), index);
 			}
+			if (m_Properties.WorldFloor)
+				sweep(floor, glm::vec3{0.0f}, BodyHandle::INVALID_INDEX - 1);
+
+			if (nearestT > 1.0f)
+				continue;
+
+			// Stop at the first touch, a little inside so the next step's narrowphase reports the contact
+			m_Bodies.Positions.Set(i, start + motion * nearestT + nearestNormal * (0.5f * m_Properties.PenetrationSlop));
+			m_QueryTreeStale = true; // Moved after the sync above, queries refit it again
+
+			// and take out the approaching velocity like the solver would. Only awake dynamic bodies give way.
+			const bool otherBody = nearest < m_Bodies.Size();
+			const float inverseMassA = m_Bodies.InverseMasses[i];
+			const float inverseMassB = otherBody && m_Bodies.IsAwake(nearest) && m_Bodies.Types[nearest] == BodyType::Dynamic ? m_Bodies.InverseMasses[nearest] : 0.0f;
+			const glm::vec3 velocityA = m_Bodies.Velocities.Get(i);
+			const glm::vec3 velocityB = otherBody ? m_Bodies.Velocities.Get(nearest) : glm::vec3{0.0f};
+			const float approach = glm::dot(velocityA - velocityB, nearestNormal);
+			if (approach <= 0.0f || inverseMassA + inverseMassB == 0.0f)
+				continue;
+
+			const glm::vec3 impulse = ((1.0f + restitution) * approach / (inverseMassA + inverseMassB)) * nearestNormal;
+			m_Bodies.Velocities.Set(i, velocityA - inverseMassA * impulse);
+			if (otherBody)
+				m_Bodies.Velocities.Set(nearest, velocityB + inverseMassB * impulse);
 		}
+	}
 
-		return hit;
+	uint32_t PhysicsWorld::FindIsland(uint32_t index)
+	{
+		if (m_IslandStamps[index] != m_IslandStamp)
+		{
+			m_IslandStamps[index] = m_IslandStamp;
+			m_IslandParents[index] = index;
+			m_IslandResting[index] = 1;
+		}
+
+		// Path halving
+		while (m_IslandParents[index] != index)
+		{
+			m_IslandParents[index] = m_IslandParents[m_IslandParents[index]];
+			index = m_IslandParents[index];
+		}
+		return index;
 	}
 
-	void PhysicsWorld::ResolveCollision(float dt)
+	void PhysicsWorld::UpdateSleeping()
 	{
-		for (Body *body : m_Bodies)
+		if (!m_Properties.AllowSleeping)
+			return;
+
+		const uint32_t bodyCount = m_Bodies.Size();
+		if (m_IslandStamps.size() < bodyCount)
 		{
-			if (body->BodyCollider)
+			m_IslandParents.resize(bodyCount);
+			m_IslandStamps.resize(bodyCount, 0);
+			m_IslandResting.resize(bodyCount);
+		}
+
+		// A new stamp resets every entry at once, wrapping around would revive entries from an old step
+		if (++m_IslandStamp == 0)
+		{
+			std::fill(m_IslandStamps.begin(), m_IslandStamps.end(), 0);
+			m_IslandStamp = 1;
+		}
+
+		// Touching non static bodies share an island, static bodies do not carry an island through them.
+		// Contacts keep handles since callbacks may have removed or moved bodies.
+		const std::vector<Contact> &contacts = m_ContactCache.GetContacts();
+		for (const Contact &contact : contacts)
+		{
+			if (!m_Bodies.IsAlive(contact.A) || !m_Bodies.IsAlive(contact.B))
+				continue;
+
+			uint32_t a = m_Bodies.IndexOf(contact.A);
+			uint32_t b = m_Bodies.IndexOf(contact.B);
+			if (m_Bodies.Types[a] == BodyType::Static || m_Bodies.Types[b] == BodyType::Static)
+				continue;
+
+			uint32_t rootA = FindIsland(a);
+			uint32_t rootB = FindIsland(b);
+			if (rootA != rootB)
 			{
-				for (Body *body2 : m_Bodies)
+				m_IslandParents[rootB] = rootA;
+				m_IslandResting[rootA] &= m_IslandResting[rootB];
+			}
+		}
+
+		// An island rests once every awake member has rested long enough, sleeping members already do
+		const uint32_t awakeCount = m_Bodies.AwakeCount;
+		const float sleepTime = m_Properties.SleepTime;
+		for (uint32_t i = 0; i < awakeCount; i++)
+		{
+			if (m_Bodies.SleepTimers[i] < sleepTime)
+				m_IslandResting[FindIsland(i)] = 0;
+		}
+
+		// Resting islands fall asleep and the sleeping members of moving islands wake up
+		m_SleepChanges.clear();
+		for (uint32_t i = 0; i < awakeCount; i++)
+		{
+			if (m_IslandResting[FindIsland(i)])
+				m_SleepChanges.push_back(m_Bodies.Handles[i]);
+		}
+		const size_t sleepCount = m_SleepChanges.size();
+
+		for (const Contact &contact : contacts)
+		{
+			for (BodyHandle handle : {contact.A, contact.B})
+			{
+				if (!m_Bodies.IsAlive(handle))
+					continue;
+
+				uint32_t index = m_Bodies.IndexOf(handle);
+				if (!m_Bodies.IsAwake(index) && m_Bodies.Types[index] != BodyType::Static && !m_IslandResting[FindIsland(index)])
+					m_SleepChanges.push_back(handle);
+			}
+		}
+
+		// Dense indices shift with every change, go through the handles
+		for (size_t i = 0; i < m_SleepChanges.size(); i++)
+		{
+			uint32_t index = m_Bodies.IndexOf(m_SleepChanges[i]);
+			if (i < sleepCount)
+				m_Bodies.Sleep(index);
+			else
+				m_Bodies.Wake(index);
+		}
+	}
+
+	void PhysicsWorld::SyncQueryTree()
+	{
+		if (!m_Bodies.Dirty)
+		{
+			if (!m_QueryTreeStale)
+				return;
+
+			// Only the awake range moved since the last sync and bounded bodies stay bounded
+			m_QueryTreeStale = false;
+			Transform transform;
+			for (uint32_t i = 0; i < m_Bodies.AwakeCount; i++)
+			{
+				const QueryProxy &queryProxy = m_QueryProxies[m_Bodies.Handles[i].Index];
+				if (queryProxy.Proxy == DynamicAABBTree::NULL_NODE)
+					continue;
+
+				AABB bounds;
+				transform.Position = m_Bodies.Positions.Get(i);
+				m_Bodies.Colliders[i]->ComputeAABB(&transform, bounds);
+				m_QueryTree.MoveProxy(queryProxy.Proxy, bounds);
+			}
+			return;
+		}
+		m_Bodies.Dirty = false;
+		m_QueryTreeStale = false;
+
+		// Drop leaves of removed bodies
+		for (uint32_t slot = 0; slot < static_cast<uint32_t>(m_QueryProxies.size()); slot++)
+		{
+			QueryProxy &queryProxy = m_QueryProxies[slot];
+			if (queryProxy.Proxy != DynamicAABBTree::NULL_NODE && !m_Bodies.IsAlive({slot, queryProxy.Generation}))
+			{
+				m_QueryTree.DestroyProxy(queryProxy.Proxy);
+				queryProxy.Proxy = DynamicAABBTree::NULL_NODE;
+			}
+		}
+
+		// Refit the rest, bodies still inside their fat bounds cost a single containment test
+		m_UnboundedBodies.clear();
+		Transform transform;
+		for (uint32_t i = 0; i < m_Bodies.Size(); i++)
+		{
+			const BodyHandle handle = m_Bodies.Handles[i];
+			if (handle.Index >= m_QueryProxies.size())
+				m_QueryProxies.resize(handle.Index + 1);
+
+			QueryProxy &queryProxy = m_QueryProxies[handle.Index];
+			queryProxy.Generation = handle.Generation;
+			const Collider *collider = m_Bodies.Colliders[i];
+
+			AABB bounds;
+			transform.Position = m_Bodies.Positions.Get(i);
+			bool bounded = collider != nullptr && collider->ComputeAABB(&transform, bounds);
+			if (!bounded)
+			{
+				if (queryProxy.Proxy != DynamicAABBTree::NULL_NODE)
 				{
-					// Break So Collisions are not Doubled
-					if (body == body2)
-						break;
-
-					CollisionPoints collisionPoints = body->BodyCollider->TestCollision(&body->BodyTransform, body2->BodyCollider, &body2->BodyTransform);
-					if (collisionPoints.DidCollide)
-					{
-						// TODO: Set WithinCollisionFlag to true
-						m_CollisionEnterCallback(collisionPoints, body->GetEntityOwnerID(), body2->GetEntityOwnerID());
-
-						// TODO: Resolve Collision
-						// ResolveCollision(body, body2, collisionPoints);
-					}
+					m_QueryTree.DestroyProxy(queryProxy.Proxy);
+					queryProxy.Proxy = DynamicAABBTree::NULL_NODE;
 				}
+
+				if (collider != nullptr)
+					m_UnboundedBodies.push_back(handle.Index);
+				continue;
+			}
+
+			if (queryProxy.Proxy == DynamicAABBTree::NULL_NODE)
+			{
+				queryProxy.Proxy = m_QueryTree.CreateProxy(bounds, handle.Index);
+			}
+			else
+			{
+				m_QueryTree.MoveProxy(queryProxy.Proxy, bounds);
+			}
+		}
+	}
+
+	bool PhysicsWorld::RaycastBody(const Ray *ray, uint32_t index, uint32_t mask, float maxT, float &t) const
+	{
+		if ((m_Bodies.Filters[index].Category & mask) == 0)
+			return false;
+
+		const Collider *collider = m_Bodies.Colliders[index];
+		if (collider->Type == ColliderType::Sphere)
+		{
+			const SphereCollider *sphere = static_cast<const SphereCollider *>(collider);
+			glm::vec3 center = m_Bodies.Positions.Get(index) + sphere->Center;
+			return algo::FindRaySphereDistance(ray->Origin, ray->Direction, center, sphere->Radius, t) && t <= maxT;
+		}
+
+		CollisionPoints col;
+		if (collider->Type == ColliderType::Plane)
+		{
+			// Placed at the body like the narrowphase does, PlaneCollider's own ray test only reads the collider
+			const PlaneCollider *plane = static_cast<const PlaneCollider *>(collider);
+			col = algo::FindRayPlaneCollisionPoints(ray->Origin, ray->Direction, m_Bodies.Positions.Get(index) + plane->Origin, plane->Normal);
+		}
+		else
+		{
+			Transform transform;
+			transform.Position = m_Bodies.Positions.Get(index);
+			col = collider->TestCollision(&transform, ray, nullptr);
+		}
+		if (!col.DidCollide)
+			return false;
+
+		t = glm::dot(col.A - ray->Origin, ray->Direction) / glm::dot(ray->Direction, ray->Direction);
+		return t >= 0.0f && t <= maxT;
+	}
+
+	PhysicsWorld::Raycasthit PhysicsWorld::Raycast(const Ray *ray, float distance, uint32_t mask)
+	{
+		SyncQueryTree();
+		return RaycastNearest(ray, distance, mask);
+	}
+
+	// Work below this many rays is not worth waking the workers for
+	static constexpr uint32_t RAYCAST_RANGE = 64;
+
+	void PhysicsWorld::RaycastBatch(const Ray *rays, uint32_t count, Raycasthit *hits, float distance, uint32_t mask)
+	{
+		SyncQueryTree();
+
+		m_Workers->ParallelFor(count, RAYCAST_RANGE, [this, rays, hits, distance, mask](uint32_t begin, uint32_t end, uint32_t)
+							   {
+			for (uint32_t i = begin; i < end; i++)
+				hits[i] = RaycastNearest(&rays[i], distance, mask); });
+	}
+
+	PhysicsWorld::Raycasthit PhysicsWorld::RaycastNearest(const Ray *ray, float distance, uint32_t mask) const
+	{
+		Raycasthit hit = Raycasthit();
+		float directionLength = glm::length(ray->Direction);
+		if (directionLength == 0.0f)
+			return hit;
+
+		float nearestT = distance / directionLength;
+		uint32_t nearestIndex = BodyHandle::INVALID_INDEX;
+		auto testBody = [&](uint32_t index, float maxT)
+		{
+			float t;
+			if (!RaycastBody(ray, index, mask, maxT, t))
+				return maxT;
+
+			nearestT = t;
+			nearestIndex = index;
+			return t;
+		};
+
+		// Each hit shrinks the ray so the tree skips everything behind it
+		m_QueryTree.Raycast(ray->Origin, ray->Direction, nearestT, [&](int32_t proxy, float maxT)
+							{ return testBody(QueryBodyIndex(m_QueryTree.GetUserData(proxy)), maxT); });
+		for (uint32_t slot : m_UnboundedBodies)
+			testBody(QueryBodyIndex(slot), nearestT);
+
+		if (nearestIndex != BodyHandle::INVALID_INDEX)
+		{
+			hit.CollisionPoint = ray->Origin + ray->Direction * nearestT;
+			hit.Handle = m_Bodies.Handles[nearestIndex];
+			hit.EntityOwnerID = m_Bodies.OwnerEntityIDs[nearestIndex];
+			hit.Distance = nearestT * directionLength;
+		}
+
+		return hit;
+	}
+
+	uint32_t PhysicsWorld::RaycastAll(const Ray *ray, std::vector<Raycasthit> &hits, float distance, uint32_t mask)
+	{
+		hits.clear();
+		float directionLength = glm::length(ray->Direction);
+		if (directionLength == 0.0f)
+			return 0;
+
+		SyncQueryTree();
+
+		const float maxT = distance / directionLength;
+		auto testBody = [&](uint32_t index)
+		{
+			float t;
+			if (!RaycastBody(ray, index, mask, maxT, t))
+				return;
+
+			Raycasthit hit;
+			hit.CollisionPoint = ray->Origin + ray->Direction * t;
+			hit.Handle = m_Bodies.Handles[index];
+			hit.EntityOwnerID = m_Bodies.OwnerEntityIDs[index];
+			hit.Distance = t * directionLength;
+			hits.push_back(hit);
+		};
+
+		// Spheres the ray reaches in the tree are tested in one batch, other colliders one by one
+		m_RaySpheres.Clear();
+		m_RaySphereBodies.clear();
+		m_QueryTree.Raycast(ray->Origin, ray->Direction, maxT, [&](int32_t proxy, float)
+							{
+			uint32_t index = QueryBodyIndex(m_QueryTree.GetUserData(proxy));
+			const Collider *collider = m_Bodies.Colliders[index];
+			if (collider->Type != ColliderType::Sphere)
+				testBody(index);
+			else if (m_Bodies.Filters[index].Category & mask)
+			{
+				const SphereCollider *sphere = static_cast<const SphereCollider *>(collider);
+				m_RaySpheres.Push(m_Bodies.Positions.Get(index) + sphere->Center, sphere->Radius);
+				m_RaySphereBodies.push_back(index);
+			}
+			return maxT; });
+		for (uint32_t slot : m_UnboundedBodies)
+			testBody(QueryBodyIndex(slot));
+
+		// The kernel expects a unit direction, its t values are distances
+		const Ray unitRay(ray->Origin, ray->Direction / directionLength);
+		algo::TestRaySphereBatch(&unitRay, m_RaySpheres, m_RaySphereHits);
+		for (uint32_t i = 0; i < m_RaySpheres.Size(); i++)
+		{
+			if (!m_RaySphereHits.Hits.IsHit(i))
+				continue;
+
+			// Where the ray enters the sphere, or leaves it if the origin is inside
+			float hitDistance = m_RaySphereHits.TNear[i] >= 0.0f ? m_RaySphereHits.TNear[i] : m_RaySphereHits.TFar[i];
+			if (hitDistance < 0.0f || hitDistance > distance)
+				continue;
+
+			const uint32_t index = m_RaySphereBodies[i];
+			Raycasthit hit;
+			hit.CollisionPoint = ray->Origin + unitRay.Direction * hitDistance;
+			hit.Handle = m_Bodies.Handles[index];
+			hit.EntityOwnerID = m_Bodies.OwnerEntityIDs[index];
+			hit.Distance = hitDistance;
+			hits.push_back(hit);
+		}
+
+		std::sort(hits.begin(), hits.end(), [](const Raycasthit &a, const Raycasthit &b)
+				  { return a.Distance < b.Distance; });
+		return static_cast<uint32_t>(hits.size());
+	}
+
+	uint32_t PhysicsWorld::OverlapAABB(const AABB &bounds, std::vector<OverlapHit> &hits, uint32_t mask)
+	{
+		hits.clear();
+		SyncQueryTree();
+
+		// Leaves hold fat bounds, test the tight bounds before reporting
+		Transform transform;
+		m_QueryTree.QueryAABB(bounds, [&](int32_t proxy)
+							  {
+			uint32_t index = QueryBodyIndex(m_QueryTree.GetUserData(proxy));
+			if ((m_Bodies.Filters[index].Category & mask) == 0)
+				return true;
+
+			AABB bodyBounds;
+			transform.Position = m_Bodies.Positions.Get(index);
+			if (m_Bodies.Colliders[index]->ComputeAABB(&transform, bodyBounds) && bodyBounds.Overlaps(bounds))
+				hits.push_back({m_Bodies.Handles[index], m_Bodies.OwnerEntityIDs[index]});
+			return true; });
+
+		return static_cast<uint32_t>(hits.size());
+	}
+
+	uint32_t PhysicsWorld::OverlapSphere(const glm::vec3 &center, float radius, std::vector<OverlapHit> &hits, uint32_t mask)
+	{
+		hits.clear();
+		SyncQueryTree();
+
+		Transform transform;
+		m_QueryTree.QuerySphere(center, radius, [&](int32_t proxy)
+								{
+			uint32_t index = QueryBodyIndex(m_QueryTree.GetUserData(proxy));
+			if ((m_Bodies.Filters[index].Category & mask) == 0)
+				return true;
+
+			const Collider *collider = m_Bodies.Colliders[index];
+			transform.Position = m_Bodies.Positions.Get(index);
+
+			bool touching = false;
+			if (collider->Type == ColliderType::Sphere)
+			{
+				const SphereCollider *sphere = static_cast<const SphereCollider *>(collider);
+				touching = glm::length(transform.Position + sphere->Center - center) < radius + sphere->Radius;
+			}
+			else
+			{
+				AABB bodyBounds;
+				collider->ComputeAABB(&transform, bodyBounds);
+				glm::vec3 offset = glm::clamp(center, bodyBounds.Min, bodyBounds.Max) - center;
+				touching = glm::dot(offset, offset) <= radius * radius;
+			}
+
+			if (touching)
+				hits.push_back({m_Bodies.Handles[index], m_Bodies.OwnerEntityIDs[index]});
+			return true; });
+
+		return static_cast<uint32_t>(hits.size());
+	}
+
+	void PhysicsWorld::ResolveCollision(float dt)
+	{
+		UpdateBroadphaseProxies();
+		m_Broadphase->FindPairs(m_Proxies, m_Pairs);
+
+		// Chunk the pairs without splitting a run of pairs sharing A, so every run is still one batch
+		m_PairChunks.clear();
+		uint32_t chunkStart = 0;
+		const uint32_t pairCount = static_cast<uint32_t>(m_Pairs.size());
+		while (chunkStart < pairCount)
+		{
+			m_PairChunks.push_back(chunkStart);
+
+			uint32_t chunkEnd = std::min(chunkStart + PAIR_CHUNK, pairCount);
+			while (chunkEnd < pairCount && m_Pairs[chunkEnd].A == m_Pairs[chunkEnd - 1].A)
+				chunkEnd++;
+			chunkStart = chunkEnd;
+		}
+
+		const uint32_t chunkCount = static_cast<uint32_t>(m_PairChunks.size());
+		m_ChunkEvents.resize(std::max(static_cast<uint32_t>(m_ChunkEvents.size()), chunkCount));
+		m_Workers->ParallelFor(chunkCount, 1, [this, pairCount](uint32_t begin, uint32_t end, uint32_t worker)
+							   {
+			for (uint32_t chunk = begin; chunk < end; chunk++)
+			{
+				uint32_t chunkEnd = chunk + 1 < static_cast<uint32_t>(m_PairChunks.size()) ? m_PairChunks[chunk + 1] : pairCount;
+				m_ChunkEvents[chunk].clear();
+				TestPairs(m_PairChunks[chunk], chunkEnd, m_Scratch[worker], m_ChunkEvents[chunk]);
+			} });
+
+		m_StepContacts.clear();
+		for (uint32_t chunk = 0; chunk < chunkCount; chunk++)
+		{
+			for (const CollisionEvent &event : m_ChunkEvents[chunk])
+			{
+				Contact contact;
+				contact.A = m_Bodies.Handles[event.Pair.A];
+				contact.B = m_Bodies.Handles[event.Pair.B];
+				contact.Key = ContactCache::MakeKey(contact.A, contact.B);
+				contact.EntityA = m_Bodies.OwnerEntityIDs[event.Pair.A];
+				contact.EntityB = m_Bodies.OwnerEntityIDs[event.Pair.B];
+				contact.Points = event.Points;
+				contact.Order = static_cast<uint32_t>(m_StepContacts.size());
+				m_StepContacts.push_back(contact);
+			}
+		}
+
+		// Pairs of inactive bodies were not tested, they still touch the way they did when they stopped moving
+		const uint32_t testedCount = static_cast<uint32_t>(m_StepContacts.size());
+		for (const Contact &contact : m_ContactCache.GetContacts())
+		{
+			if (m_Bodies.IsAlive(contact.A) && m_Bodies.IsAlive(contact.B) &&
+				!m_Bodies.IsAwake(m_Bodies.IndexOf(contact.A)) && !m_Bodies.IsAwake(m_Bodies.IndexOf(contact.B)))
+			{
+				m_StepContacts.push_back(contact);
+				m_StepContacts.back().Order = -1;
+			}
+		}
+
+		// Compare with the last step, transitions come out in key order so callbacks do not depend on the thread count
+		m_ContactCache.Update(m_StepContacts, m_ContactTransitions, m_Bodies);
+
+		// The solver goes through this step's contacts in pair order, which follows the dense layout rather than handle slots
+		m_SolverContacts.clear();
+		if (m_Properties.SolverIterations > 0)
+		{
+			const std::vector<Contact> &contacts = m_ContactCache.GetContacts();
+			m_SolverContacts.resize(testedCount);
+			for (uint32_t i = 0; i < static_cast<uint32_t>(contacts.size()); i++)
+			{
+				if (contacts[i].Order < testedCount)
+					m_SolverContacts[contacts[i].Order] = i;
+			}
+		}
+
+		// The world floor is only tested against the bodies the broadphase found reaching down to it. It is no entity so it
+		// fires no callbacks, its contacts are only cached to warm start the solver.
+		if (m_Properties.WorldFloor)
+		{
+			const Shape floor = GetFloorShape();
+			Broadphase::FindFloorCandidates(m_Proxies, m_Bodies.AwakeCount, m_Properties.WorldFloorHeight, m_FloorCandidates);
+			for (uint32_t i : m_FloorCandidates)
+			{
+				glm::vec3 normal;
+				float depth;
+				if (!ComputeShapeContact(m_Bodies.Shapes[i], m_Bodies.Positions.Get(i), floor, glm::vec3{0.0f}, normal, depth))
+					continue;
+
+				Contact contact;
+				contact.A = m_Bodies.Handles[i];
+				contact.Key = ContactCache::MakeKey(contact.A, contact.B);
+				contact.EntityA = m_Bodies.OwnerEntityIDs[i];
+				contact.Order = static_cast<uint32_t>(m_StepContacts.size());
+				m_StepContacts.push_back(contact);
+			}
+		}
+
+		const uint32_t floorCount = static_cast<uint32_t>(m_StepContacts.size());
+		m_FloorContactCache.Update(m_StepContacts, m_FloorTransitions, m_Bodies);
+		m_FloorSolverContacts.resize(floorCount);
+		for (uint32_t i = 0; i < floorCount; i++)
+			m_FloorSolverContacts[m_FloorContactCache.GetContacts()[i].Order] = i;
+
+		for (const ContactTransition &transition : m_ContactTransitions)
+		{
+			if (transition.State == ContactState::Exit)
+			{
+				Contact contact = m_ContactCache.GetPreviousContacts()[transition.Index];
+				m_CollisionExitCallback(contact.Points, contact.EntityA, contact.EntityB);
+				continue;
+			}
+
+			Contact contact = m_ContactCache.GetContacts()[transition.Index];
+			if (transition.State == ContactState::Enter)
+				m_CollisionEnterCallback(contact.Points, contact.EntityA, contact.EntityB);
+			else
+				m_CollisionStayCallback(contact.Points, contact.EntityA, contact.EntityB);
+		}
+	}
+
+	void PhysicsWorld::TestPairs(uint32_t begin, uint32_t end, NarrowphaseScratch &scratch, std::vector<CollisionEvent> &events)
+	{
+		// Bucket the pairs by shape combination so every bucket runs one routine. Stable, so buckets stay sorted by A.
+		const uint32_t bucketCount = SHAPE_TYPE_COUNT * SHAPE_TYPE_COUNT;
+		auto bucketOf = [this](uint32_t pair)
+		{ return static_cast<uint32_t>(m_Bodies.Shapes[m_Pairs[pair].A].Type) * SHAPE_TYPE_COUNT + static_cast<uint32_t>(m_Bodies.Shapes[m_Pairs[pair].B].Type); };
+
+		std::fill(std::begin(scratch.BucketStarts), std::end(scratch.BucketStarts), 0);
+		for (uint32_t p = begin; p < end; p++)
+			scratch.BucketStarts[bucketOf(p) + 1]++;
+		for (uint32_t bucket = 0; bucket < bucketCount; bucket++)
+			scratch.BucketStarts[bucket + 1] += scratch.BucketStarts[bucket];
+
+		uint32_t cursors[bucketCount];
+		std::copy_n(scratch.BucketStarts, bucketCount, cursors);
+		scratch.Buckets.resize(end - begin);
+		for (uint32_t p = begin; p < end; p++)
+			scratch.Buckets[cursors[bucketOf(p)]++] = p;
+
+		for (uint32_t bucket = 0; bucket < bucketCount; bucket++)
+		{
+			const uint32_t *pairs = scratch.Buckets.data() + scratch.BucketStarts[bucket];
+			const uint32_t count = scratch.BucketStarts[bucket + 1] - scratch.BucketStarts[bucket];
+			if (count == 0)
+				continue;
+
+			const ColliderType typeA = static_cast<ColliderType>(bucket / SHAPE_TYPE_COUNT);
+			const ColliderType typeB = static_cast<ColliderType>(bucket % SHAPE_TYPE_COUNT);
+			if (typeA == ColliderType::Sphere && typeB == ColliderType::Sphere)
+			{
+				TestSpherePairs(pairs, count, scratch, events);
+				continue;
+			}
+
+			// Combinations without a routine never collide, skip the whole bucket
+			const ShapeCollisionFn collide = GetShapeCollisionFn(typeA, typeB);
+			if (collide == nullptr)
+				continue;
+
+			for (uint32_t i = 0; i < count; i++)
+			{
+				const BodyPair &pair = m_Pairs[pairs[i]];
+				CollisionPoints collisionPoints = collide(m_Bodies.Shapes[pair.A], m_Bodies.Positions.Get(pair.A), m_Bodies.Shapes[pair.B], m_Bodies.Positions.Get(pair.B));
+				if (collisionPoints.DidCollide)
+					events.push_back({collisionPoints, pair});
 			}
 		}
 	}
 
+	void PhysicsWorld::TestSpherePairs(const uint32_t *pairs, uint32_t count, NarrowphaseScratch &scratch, std::vector<CollisionEvent> &events)
+	{
+		// Pairs are sorted by A, so every run of pairs sharing A is one sphere against a packet of spheres
+		uint32_t runStart = 0;
+		while (runStart < count)
+		{
+			const uint32_t bodyA = m_Pairs[pairs[runStart]].A;
+			uint32_t runEnd = runStart + 1;
+			while (runEnd < count && m_Pairs[pairs[runEnd]].A == bodyA)
+				runEnd++;
+
+			scratch.Spheres.Clear();
+			for (uint32_t i = runStart; i < runEnd; i++)
+			{
+				const uint32_t bodyB = m_Pairs[pairs[i]].B;
+				const SphereShape &sphere = m_Bodies.Shapes[bodyB].Sphere;
+				scratch.Spheres.Push(m_Bodies.Positions.Get(bodyB) + sphere.Center, sphere.Radius);
+			}
+
+			const SphereShape &sphereA = m_Bodies.Shapes[bodyA].Sphere;
+			algo::TestSphereBatch(m_Bodies.Positions.Get(bodyA) + sphereA.Center, sphereA.Radius, scratch.Spheres, scratch.Contacts);
+
+			for (uint32_t i = runStart; i < runEnd; i++)
+			{
+				if (scratch.Contacts.Hits.IsHit(i - runStart))
+					events.push_back({CollisionPoints{scratch.Contacts.GetDelta(i - runStart) / 2.0f, true}, m_Pairs[pairs[i]]});
+			}
+
+			runStart = runEnd;
+		}
+	}
+
+	void PhysicsWorld::UpdateBroadphaseProxies()
+	{
+		// Inactive proxies only change when bodies are added, removed, woken, put to sleep or teleported
+		uint32_t count = m_Bodies.AwakeCount;
+		if (m_Bodies.ProxiesDirty || m_Proxies.size() != m_Bodies.Size())
+		{
+			m_Proxies.resize(m_Bodies.Size());
+			m_Bodies.ProxiesDirty = false;
+			m_Broadphase->OnProxiesReordered();
+			count = m_Bodies.Size();
+		}
+
+		m_Workers->ParallelFor(count, PROXY_RANGE, [this](uint32_t begin, uint32_t end, uint32_t)
+							   {
+			for (uint32_t i = begin; i < end; i++)
+			{
+				// Picks up changes made to the collider since it was set
+				const Shape &shape = m_Bodies.Shapes[i] = Shape::FromCollider(m_Bodies.Colliders[i]);
+				BroadphaseProxy &proxy = m_Proxies[i];
+
+				proxy.Collidable = shape.Type != ColliderType::None;
+				proxy.Bounded = proxy.Collidable && ComputeShapeAABB(shape, m_Bodies.Positions.Get(i), proxy.Bounds);
+				proxy.Active = m_Bodies.IsAwake(i);
+				proxy.Filter = m_Bodies.Filters[i];
+			} });
+	}
+
 	void PhysicsWorld::AddBody(Body *body)
 	{
-		m_Bodies.push_back(body);
+		if (body->IsRegistered())
+			return;
+
+		body->m_Handle = m_Bodies.Create(body->m_State);
+		body->m_Store = &m_Bodies;
 	}
 
 	void PhysicsWorld::RemoveBody(Body *body)
 	{
-		m_Bodies.erase(remove(m_Bodies.begin(), m_Bodies.end(), body), m_Bodies.end());
+		if (!body->IsRegistered())
+			return;
+
+		// Keep the last known state so the body can be registered again
+		body->m_State = body->GetState();
+		m_Bodies.Destroy(body->m_Handle);
+		body->m_Handle = {};
+		body->m_Store = nullptr;
 	}
 
 	void PhysicsWorld::Clear()
 	{
-		m_Bodies.clear();
+		m_Bodies.Clear();
+		m_ContactCache.Clear();
+		m_FloorContactCache.Clear();
+		m_QueryTree.Clear();
+		m_QueryProxies.clear();
+		m_UnboundedBodies.clear();
+		m_QueryTreeStale = false;
+		m_Accumulator = 0.0f;
+	}
+
+	void PhysicsWorld::SetBroadphase(BroadphaseType type)
+	{
+		m_Properties.Broadphase = type;
+		m_Broadphase = Broadphase::CreateBroadphase(type, m_Properties.SpatialHashCellSize);
+	}
+
+	void PhysicsWorld::SetFixedTimeStep(float timeStep, uint32_t maxSubSteps)
+	{
+		m_Properties.FixedTimeStep = timeStep;
+		m_Properties.MaxSubSteps = maxSubSteps;
+		m_Accumulator = 0.0f;
+	}
+
+	void PhysicsWorld::SetThreadCount(uint32_t count)
+	{
+		m_Properties.ThreadCount = count;
+		m_Workers = std::make_unique<WorkerPool>(count);
+		m_Scratch.resize(m_Workers->GetThreadCount());
+	}
+
+	void PhysicsWorld::SetTaskExecutor(TaskExecutor *executor)
+	{
+		if (executor)
+			m_Workers = std::make_unique<WorkerPool>(executor);
+		else
+			m_Workers = std::make_unique<WorkerPool>(m_Properties.ThreadCount);
+		m_Scratch.resize(m_Workers->GetThreadCount());
+	}
+
+	void PhysicsWorld::SetAllowSleeping(bool allowSleeping)
+	{
+		m_Properties.AllowSleeping = allowSleeping;
+		if (allowSleeping)
+			return;
+
+		// Waking swaps the body with the first inactive one, which is static when it lands behind i
+		for (uint32_t i = m_Bodies.AwakeCount; i < m_Bodies.Size(); i++)
+			m_Bodies.Wake(i);
 	}
 
 	void PhysicsWorld::SetOnCollisionEnterCallBack(CollisionCallbackFn onEnterFn)
@@ -107,6 +1135,11 @@ namespace flg
 		m_CollisionEnterCallback = onEnterFn;
 	}
 
+	void PhysicsWorld::SetOnCollisionStayCallBack(CollisionCallbackFn onStayFn)
+	{
+		m_CollisionStayCallback = onStayFn;
+	}
+
 	void PhysicsWorld::SetOnCollisionExitCallBack(CollisionCallbackFn onExit)
 	{
 		m_CollisionExitCallback = onExit;
@@ -8,52 +8,276 @@
 #include <functional>
 
 #include "Body.h"
+#include "BodyStore.h"
 #include "Collider.h"
+#include "Shape.h"
+#include "Broadphase.h"
+#include "ContactCache.h"
+#include "AABBTree.h"
+#include "BatchAlgorithms.h"
+#include "WorkerPool.h"
 
 namespace flg
 {
     struct PhysicsWorldProperties
     {
         glm::vec3 Gravity = glm::vec3{0.0f, -9.81f, 0.0f} * 5.0f;
+
+        // Broadphase
+        BroadphaseType Broadphase = BroadphaseType::SpatialHash;
+        float SpatialHashCellSize = 4.0f;
+
+        // Fixed timestep used by Advance, in seconds. Frames longer than MaxSubSteps steps drop the extra time.
+        float FixedTimeStep = 1.0f / 60.0f;
+        uint32_t MaxSubSteps = 5;
+
+        // Threads used by Step, 0 uses one per hardware thread. Callbacks always fire on the calling thread.
+        uint32_t ThreadCount = 1;
+
+        // Contact solver, 0 iterations leaves overlapping bodies (and the world floor) alone
+        uint32_t SolverIterations = 8;
+        float Restitution = 0.0f;
+        float Friction = 0.3f;
+        float Baumgarte = 0.2f;        // Fraction of the penetration corrected per step
+        float PenetrationSlop = 0.01f; // Penetration left uncorrected so resting contacts do not jitter
+
+        // Bodies moving more than ContinuousThreshold times their radius in a step (or flagged with Body::SetContinuousCollision)
+        // are swept from where they started, and stopped at the first body or plane in the way instead of passing through it
+        bool ContinuousCollision = true;
+        float ContinuousThreshold = 0.5f;
+
+        // Ground plane facing up, resolved like any other contact. Bodies touching it get no collision callbacks.
+        bool WorldFloor = true;
+        float WorldFloorHeight = 0.4f;
+
+        // Bodies slower than SleepVelocity for SleepTime seconds, together with everything they touch, stop being simulated
+        bool AllowSleeping = true;
+        float SleepVelocity = 0.1f;
+        float SleepTime = 0.5f;
+
+        // Steps always advance by FixedTimeStep, bodies are ordered by owner entity ID before every step and a hash of
+        // every body's position and velocity is kept per step. Build with FLAG_STRICT_FLOAT for results that match across builds.
+        bool Deterministic = false;
     };
 
-    // World that holds a reference to all physics bodies
+    class PhysicsRecording;
+
+    // World that holds a reference to all physics bodies. Worlds share no state, so independent worlds can step
+    // concurrently on different threads. A world has to outlive the bodies added to it.
     class PhysicsWorld
     {
     public:
+        PhysicsWorld(const PhysicsWorldProperties &properties = PhysicsWorldProperties{});
         PhysicsWorld(const PhysicsWorld &other) = delete;
         void operator=(const PhysicsWorld &other) = delete;
         ~PhysicsWorld();
 
-        static void Step(float dt);
-        static void AddBody(Body *body);
-        static void RemoveBody(Body *body);
-        static void Clear();
+        void Step(float dt);
+
+        // Runs as many fixed steps as fit in the accumulated frame time and returns how many ran
+        uint32_t Advance(float frameTime);
+
+        // How far the leftover accumulated time is into the next fixed step, in [0, 1)
+        float GetInterpolationAlpha() const { return m_Accumulator / m_Properties.FixedTimeStep; }
+
+        void SetFixedTimeStep(float timeStep, uint32_t maxSubSteps = 5);
+        float GetFixedTimeStep() const { return m_Properties.FixedTimeStep; }
+        void AddBody(Body *body);
+        void RemoveBody(Body *body);
+        void Clear();
+
+        BodyStore &GetBodyStore() { return m_Bodies; }
+        const BodyStore &GetBodyStore() const { return m_Bodies; }
+
+        void SetProperties(const PhysicsWorldProperties &properties);
+        const PhysicsWorldProperties &GetProperties() const { return m_Properties; }
+
+        void SetBroadphase(BroadphaseType type);
+        BroadphaseType GetBroadphase() const { return m_Properties.Broadphase; }
+
+        void SetThreadCount(uint32_t count);
+        uint32_t GetThreadCount() const { return m_Workers->GetThreadCount(); }
+
+        // Runs the step's parallel work on a host engine's threads instead of threads of the world's own.
+        // nullptr (or SetThreadCount) goes back to ThreadCount threads. The executor has to outlive the world.
+        void SetTaskExecutor(TaskExecutor *executor);
+
+        // Disabling sleeping wakes every body
+        void SetAllowSleeping(bool allowSleeping);
+        bool GetAllowSleeping() const { return m_Properties.AllowSleeping; }
+
+        void SetDeterministic(bool deterministic) { m_Properties.Deterministic = deterministic; }
+        bool IsDeterministic() const { return m_Properties.Deterministic; }
+
+        // Order independent hash of every body's owner, position and velocity
+        uint64_t ComputeStateHash() const;
+
+        // State hash after the last step, only kept while deterministic or recording
+        uint64_t GetStepHash() const { return m_StepHash; }
+
+        // Records every step into recording until StopRecording, turns deterministic mode on. See Replay.h
+        void StartRecording(PhysicsRecording *recording);
+        void StopRecording() { m_Recording = nullptr; }
 
         using CollisionCallbackFn = std::function<void(flg::CollisionPoints &col, uint32_t entityA, uint32_t entityB)>;
-        static void SetOnCollisionEnterCallBack(CollisionCallbackFn onEnterFn);
-        static void SetOnCollisionExitCallBack(CollisionCallbackFn onExit);
+        void SetOnCollisionEnterCallBack(CollisionCallbackFn onEnterFn);
+        void SetOnCollisionStayCallBack(CollisionCallbackFn onStayFn);
+        void SetOnCollisionExitCallBack(CollisionCallbackFn onExit);
+
+        // Contacts found by the last step
+        const std::vector<Contact> &GetContacts() const { return m_ContactCache.GetContacts(); }
 
     public:
         struct Raycasthit
         {
             glm::vec3 CollisionPoint = {};
-            Body *body;
+            BodyHandle Handle = {};
+            uint32_t EntityOwnerID = -1;
+            float Distance = 0.0f;
+
+            bool DidHit() { return Handle.IsValid(); };
+        };
 
-            bool DidHit() { return body != nullptr; };
+        struct OverlapHit
+        {
+            BodyHandle Handle = {};
+            uint32_t EntityOwnerID = -1;
         };
 
-        static Raycasthit Raycast(const Ray *ray, float distance = 1000.0f);
-        static std::function<void(CollisionPoints &col, uint32_t entityA, uint32_t entityB)> m_CollisionEnterCallback;
-        static std::function<void(CollisionPoints &col, uint32_t entityA, uint32_t entityB)> m_CollisionExitCallback;
+        // Queries only report bodies whose collision category shares a bit with mask (see CollisionFilter)
+
+        // Nearest hit within distance
+        Raycasthit Raycast(const Ray *ray, float distance = 1000.0f, uint32_t mask = CollisionFilter::ALL);
+
+        // Nearest hit for each of count rays, written to hits[i]. The query tree is synced once for the batch
+        // and the rays are spread over the worker threads. Call from the thread that steps the world.
+        void RaycastBatch(const Ray *rays, uint32_t count, Raycasthit *hits, float distance = 1000.0f, uint32_t mask = CollisionFilter::ALL);
+
+        // Every hit within distance sorted nearest first, returns the hit count
+        uint32_t RaycastAll(const Ray *ray, std::vector<Raycasthit> &hits, float distance = 1000.0f, uint32_t mask = CollisionFilter::ALL);
+
+        // Bodies touching the bounds or sphere. Bodies without finite bounds (i.e planes) are not reported.
+        uint32_t OverlapAABB(const AABB &bounds, std::vector<OverlapHit> &hits, uint32_t mask = CollisionFilter::ALL);
+        uint32_t OverlapSphere(const glm::vec3 &center, float radius, std::vector<OverlapHit> &hits, uint32_t mask = CollisionFilter::ALL);
 
     private:
-        static void ResolveCollision(float dt);
+        // Batch kernel buffers, one set per worker
+        struct NarrowphaseScratch
+        {
+            algo::SpherePacket Spheres;
+            algo::SphereBatchContacts Contacts;
+
+            // Pairs of a chunk grouped by shape combination, bucket b spans [BucketStarts[b], BucketStarts[b + 1])
+            std::vector<uint32_t> Buckets;
+            uint32_t BucketStarts[SHAPE_TYPE_COUNT * SHAPE_TYPE_COUNT + 1];
+        };
+
+        struct CollisionEvent
+        {
+            CollisionPoints Points;
+            BodyPair Pair;
+        };
+
+        void ResolveCollision(float dt);
+        void TestPairs(uint32_t begin, uint32_t end, NarrowphaseScratch &scratch, std::vector<CollisionEvent> &events);
+        void TestSpherePairs(const uint32_t *pairs, uint32_t count, NarrowphaseScratch &scratch, std::vector<CollisionEvent> &events);
+        void IntegrateVelocities(float dt);
+        void SolveContacts(float dt);
+        void IntegratePositions(float dt);
+        void SweepFastBodies();
+        Shape GetFloorShape();
+        void UpdateSleeping();
+        void UpdateBroadphaseProxies();
+        uint32_t FindIsland(uint32_t index);
+
+        // Scene queries
+        void SyncQueryTree();
+        uint32_t QueryBodyIndex(uint32_t slot) const { return m_Bodies.IndexOf({slot, m_QueryProxies[slot].Generation}); }
+        bool RaycastBody(const Ray *ray, uint32_t index, uint32_t mask, float maxT, float &t) const;
+        Raycasthit RaycastNearest(const Ray *ray, float distance, uint32_t mask) const; // Expects a synced query tree, safe to call from workers
 
     private:
-        PhysicsWorld() {}
-        static std::vector<Body *> m_Bodies;
-        static PhysicsWorldProperties m_Properties;
+        BodyStore m_Bodies;
+        PhysicsWorldProperties m_Properties;
+        float m_Accumulator = 0.0f;
+
+        // Determinism
+        uint64_t m_StepHash = 0;
+        PhysicsRecording *m_Recording = nullptr;
+
+        // Callbacks
+        CollisionCallbackFn m_CollisionEnterCallback = [](CollisionPoints &, uint32_t, uint32_t) {};
+        CollisionCallbackFn m_CollisionStayCallback = [](CollisionPoints &, uint32_t, uint32_t) {};
+        CollisionCallbackFn m_CollisionExitCallback = [](CollisionPoints &, uint32_t, uint32_t) {};
+
+        // Broadphase
+        std::unique_ptr<Broadphase> m_Broadphase;
+        std::vector<BroadphaseProxy> m_Proxies;
+        std::vector<BodyPair> m_Pairs;
+
+        // Threading
+        std::unique_ptr<WorkerPool> m_Workers;
+        std::vector<NarrowphaseScratch> m_Scratch;
+
+        // Narrowphase
+        std::vector<uint32_t> m_PairChunks;                      // First pair of each chunk, chunks never split pairs sharing A
+        std::vector<std::vector<CollisionEvent>> m_ChunkEvents; // Merged in chunk order so contacts do not depend on the thread count
+
+        // Sleeping, islands are rebuilt every step with a union find over dense indices. Entries are reset lazily
+        // by stamp so a step only pays for the awake bodies and the contacts.
+        std::vector<uint32_t> m_IslandParents;
+        std::vector<uint32_t> m_IslandStamps;
+        std::vector<uint8_t> m_IslandResting; // Per island root, every awake member is ready to sleep
+        uint32_t m_IslandStamp = 0;
+        std::vector<BodyHandle> m_SleepChanges;
+
+        // Scene queries
+        struct QueryProxy
+        {
+            int32_t Proxy = DynamicAABBTree::NULL_NODE;
+            uint32_t Generation = 0;
+        };
+        DynamicAABBTree m_QueryTree;
+        std::vector<QueryProxy> m_QueryProxies;   // Body handle index -> leaf in m_QueryTree
+        std::vector<uint32_t> m_UnboundedBodies; // Handle indices of bodies that are tested on every query
+        bool m_QueryTreeStale = false;           // Set by Step, only awake bodies moved since the last sync
+        algo::SpherePacket m_RaySpheres;         // RaycastAll's sphere candidates for the batch kernel
+        algo::RayBatchHits m_RaySphereHits;
+        std::vector<uint32_t> m_RaySphereBodies; // Dense index of each packet sphere
+
+        // Solver, one constraint per contact found this step in pair order, which follows the dense layout rather than handle slots
+        struct ContactConstraint
+        {
+            uint32_t A;
+            uint32_t B;
+            uint32_t Contact; // Into the cache's contacts
+            glm::vec3 Normal;
+            float InverseMassA;
+            float InverseMassB;
+            float NormalMass;
+            float Bias; // Separating velocity the constraint aims for
+            float NormalImpulse;
+            glm::vec3 TangentImpulse;
+        };
+        std::vector<uint32_t> m_SolverContacts;
+        std::vector<ContactConstraint> m_Constraints;
+        std::vector<ContactConstraint> m_FloorConstraints; // B is the floor, not a body
+
+        static void ApplyContactImpulses(ContactConstraint &constraint, glm::vec3 &velocityA, glm::vec3 &velocityB, float friction);
+
+        // Continuous collision, dense indices of the bodies swept this step
+        std::vector<uint32_t> m_SweptBodies;
+
+        // World floor, its contacts are kept apart from the ones between bodies
+        ContactCache m_FloorContactCache;
+        std::vector<uint32_t> m_FloorCandidates;
+        std::vector<uint32_t> m_FloorSolverContacts;
+        std::vector<ContactTransition> m_FloorTransitions;
+
+        // Contacts
+        ContactCache m_ContactCache;
+        std::vector<Contact> m_StepContacts;
+        std::vector<ContactTransition> m_ContactTransitions;
     };
 }
 
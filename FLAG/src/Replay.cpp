@@ -0,0 +1,348 @@
+#include "Replay.h"
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+
+namespace flg
+{
+	bool ColliderRecord::operator==(const ColliderRecord &other) const
+	{
+		return Type == other.Type && Center == other.Center && Normal == other.Normal && Bounds == other.Bounds && Radius == other.Radius;
+	}
+
+	bool BodyRecord::operator==(const BodyRecord &other) const
+	{
+		return OwnerEntityID == other.OwnerEntityID && Position == other.Position && Velocity == other.Velocity && Force == other.Force &&
+			   InverseMass == other.InverseMass && Type == other.Type && Awake == other.Awake &&
+			   ContinuousCollision == other.ContinuousCollision && Filter == other.Filter && Collider == other.Collider;
+	}
+
+	static ColliderRecord RecordCollider(const Collider *collider)
+	{
+		ColliderRecord record;
+		if (collider == nullptr)
+			return record;
+
+		record.Type = collider->Type;
+		switch (collider->Type)
+		{
+		case ColliderType::Sphere:
+		{
+			const SphereCollider *sphere = static_cast<const SphereCollider *>(collider);
+			record.Center = sphere->Center;
+			record.Radius = sphere->Radius;
+			break;
+		}
+		case ColliderType::Plane:
+		{
+			const PlaneCollider *plane = static_cast<const PlaneCollider *>(collider);
+			record.Center = plane->Origin;
+			record.Normal = plane->Normal;
+			record.Bounds = plane->Bounds;
+			break;
+		}
+		case ColliderType::Ray:
+		{
+			const Ray *ray = static_cast<const Ray *>(collider);
+			record.Center = ray->Origin;
+			record.Normal = ray->Direction;
+			break;
+		}
+		default:
+			break;
+		}
+		return record;
+	}
+
+	static std::unique_ptr<Collider> CreateCollider(const ColliderRecord &record)
+	{
+		switch (record.Type)
+		{
+		case ColliderType::Sphere:
+			return std::make_unique<SphereCollider>(record.Center, record.Radius);
+		case ColliderType::Plane:
+		{
+			auto plane = std::make_unique<PlaneCollider>();
+			plane->Origin = record.Center;
+			plane->Normal = record.Normal;
+			plane->Bounds = record.Bounds;
+			return plane;
+		}
+		case ColliderType::Ray:
+			return std::make_unique<Ray>(record.Center, record.Normal);
+		default:
+			return nullptr;
+		}
+	}
+
+	static BodyRecord RecordBody(const BodyStore &bodies, uint32_t index)
+	{
+		BodyRecord record;
+		record.OwnerEntityID = bodies.OwnerEntityIDs[index];
+		record.Position = bodies.Positions.Get(index);
+		record.Velocity = bodies.Velocities.Get(index);
+		record.Force = bodies.Forces.Get(index);
+		record.InverseMass = bodies.InverseMasses[index];
+		record.Type = bodies.Types[index];
+		record.Awake = bodies.IsAwake(index);
+		record.ContinuousCollision = bodies.ContinuousCollision[index] != 0;
+		record.Filter = bodies.Filters[index];
+		record.Collider = RecordCollider(bodies.Colliders[index]);
+		return record;
+	}
+
+	// --- Recording ---
+	void PhysicsRecording::BeginStep(const BodyStore &bodies, float dt)
+	{
+		StepRecord step;
+		step.TimeStep = dt;
+
+		// Compare with the state the last step left behind
+		m_Stamp++;
+		for (uint32_t i = 0; i < bodies.Size(); i++)
+		{
+			BodyRecord record = RecordBody(bodies, i);
+			KnownBody &known = m_Known[record.OwnerEntityID];
+			known.Seen = m_Stamp;
+			if (!(known.Record == record))
+			{
+				known.Record = record;
+				step.Edits.push_back(record);
+			}
+		}
+
+		for (auto it = m_Known.begin(); it != m_Known.end();)
+		{
+			if (it->second.Seen != m_Stamp)
+			{
+				step.RemovedOwners.push_back(it->first);
+				it = m_Known.erase(it);
+			}
+			else
+				++it;
+		}
+
+		std::sort(step.Edits.begin(), step.Edits.end(), [](const BodyRecord &a, const BodyRecord &b)
+				  { return a.OwnerEntityID < b.OwnerEntityID; });
+		std::sort(step.RemovedOwners.begin(), step.RemovedOwners.end());
+		Steps.push_back(std::move(step));
+	}
+
+	void PhysicsRecording::EndStep(const BodyStore &bodies, uint64_t hash)
+	{
+		Steps.back().Hash = hash;
+		for (uint32_t i = 0; i < bodies.Size(); i++)
+			m_Known[bodies.OwnerEntityIDs[i]].Record = RecordBody(bodies, i);
+	}
+
+	void PhysicsRecording::Clear()
+	{
+		Steps.clear();
+		m_Known.clear();
+		m_Stamp = 0;
+	}
+
+	// --- File ---
+	static constexpr uint32_t RECORDING_MAGIC = 0x52474C46; // "FLGR"
+	static constexpr uint32_t RECORDING_VERSION = 5;
+
+	template <typename T>
+	static void Write(std::ofstream &out, const T &value)
+	{
+		out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+	}
+
+	template <typename T>
+	static bool Read(std::ifstream &in, T &value)
+	{
+		return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+	}
+
+	bool PhysicsRecording::Save(const std::string &path) const
+	{
+		std::ofstream out(path, std::ios::binary);
+		if (!out)
+			return false;
+
+		Write(out, RECORDING_MAGIC);
+		Write(out, RECORDING_VERSION);
+
+		Write(out, Properties.Gravity);
+		Write(out, Properties.Broadphase);
+		Write(out, Properties.SpatialHashCellSize);
+		Write(out, Properties.FixedTimeStep);
+		Write(out, Properties.MaxSubSteps);
+		Write(out, Properties.ThreadCount);
+		Write(out, Properties.AllowSleeping);
+		Write(out, Properties.SleepVelocity);
+		Write(out, Properties.SleepTime);
+		Write(out, Properties.Deterministic);
+		Write(out, Properties.SolverIterations);
+		Write(out, Properties.Restitution);
+		Write(out, Properties.Friction);
+		Write(out, Properties.Baumgarte);
+		Write(out, Properties.PenetrationSlop);
+		Write(out, Properties.ContinuousCollision);
+		Write(out, Properties.ContinuousThreshold);
+		Write(out, Properties.WorldFloor);
+		Write(out, Properties.WorldFloorHeight);
+
+		Write(out, static_cast<uint32_t>(Steps.size()));
+		for (const StepRecord &step : Steps)
+		{
+			Write(out, step.TimeStep);
+			Write(out, step.Hash);
+
+			Write(out, static_cast<uint32_t>(step.RemovedOwners.size()));
+			for (uint32_t owner : step.RemovedOwners)
+				Write(out, owner);
+
+			Write(out, static_cast<uint32_t>(step.Edits.size()));
+			for (const BodyRecord &body : step.Edits)
+			{
+				Write(out, body.OwnerEntityID);
+				Write(out, body.Position);
+				Write(out, body.Velocity);
+				Write(out, body.Force);
+				Write(out, body.InverseMass);
+				Write(out, body.Type);
+				Write(out, body.Awake);
+				Write(out, body.ContinuousCollision);
+				Write(out, body.Filter.Category);
+				Write(out, body.Filter.Mask);
+				Write(out, body.Collider.Type);
+				Write(out, body.Collider.Center);
+				Write(out, body.Collider.Normal);
+				Write(out, body.Collider.Bounds);
+				Write(out, body.Collider.Radius);
+			}
+		}
+
+		return static_cast<bool>(out);
+	}
+
+	bool PhysicsRecording::Load(const std::string &path)
+	{
+		Clear();
+
+		std::ifstream in(path, std::ios::binary);
+		uint32_t magic = 0;
+		uint32_t version = 0;
+		if (!Read(in, magic) || !Read(in, version) || magic != RECORDING_MAGIC || version != RECORDING_VERSION)
+			return false;
+
+		bool ok = Read(in, Properties.Gravity) && Read(in, Properties.Broadphase) && Read(in, Properties.SpatialHashCellSize) &&
+				  Read(in, Properties.FixedTimeStep) && Read(in, Properties.MaxSubSteps) && Read(in, Properties.ThreadCount) &&
+				  Read(in, Properties.AllowSleeping) && Read(in, Properties.SleepVelocity) && Read(in, Properties.SleepTime) &&
+				  Read(in, Properties.Deterministic) && Read(in, Properties.SolverIterations) && Read(in, Properties.Restitution) &&
+				  Read(in, Properties.Friction) && Read(in, Properties.Baumgarte) && Read(in, Properties.PenetrationSlop) &&
+				  Read(in, Properties.ContinuousCollision) && Read(in, Properties.ContinuousThreshold) &&
+				  Read(in, Properties.WorldFloor) && Read(in, Properties.WorldFloorHeight);
+
+		uint32_t stepCount = 0;
+		ok = ok && Read(in, stepCount);
+		for (uint32_t s = 0; ok && s < stepCount; s++)
+		{
+			StepRecord step;
+			uint32_t count = 0;
+			ok = Read(in, step.TimeStep) && Read(in, step.Hash) && Read(in, count);
+
+			step.RemovedOwners.resize(ok ? count : 0);
+			for (uint32_t &owner : step.RemovedOwners)
+				ok = ok && Read(in, owner);
+
+			ok = ok && Read(in, count);
+			step.Edits.resize(ok ? count : 0);
+			for (BodyRecord &body : step.Edits)
+			{
+				ok = ok && Read(in, body.OwnerEntityID) && Read(in, body.Position) && Read(in, body.Velocity) && Read(in, body.Force) &&
+					 Read(in, body.InverseMass) && Read(in, body.Type) && Read(in, body.Awake) && Read(in, body.ContinuousCollision) &&
+					 Read(in, body.Filter.Category) && Read(in, body.Filter.Mask) && Read(in, body.Collider.Type) &&
+					 Read(in, body.Collider.Center) && Read(in, body.Collider.Normal) && Read(in, body.Collider.Bounds) &&
+					 Read(in, body.Collider.Radius);
+			}
+
+			Steps.push_back(std::move(step));
+		}
+
+		if (!ok)
+			Clear();
+		return ok;
+	}
+
+	// --- Replay ---
+	struct ReplayBody
+	{
+		Body Instance;
+		std::unique_ptr<Collider> Shape;
+		ColliderRecord ShapeRecord;
+	};
+
+	ReplayResult ReplayRecording(PhysicsWorld &world, const PhysicsRecording &recording)
+	{
+		ReplayResult result;
+
+		world.Clear();
+		PhysicsWorldProperties properties = recording.Properties;
+		properties.ThreadCount = world.GetProperties().ThreadCount;
+		world.SetProperties(properties);
+
+		std::unordered_map<uint32_t, std::unique_ptr<ReplayBody>> bodies;
+		BodyStore &store = world.GetBodyStore();
+		for (const StepRecord &step : recording.Steps)
+		{
+			for (uint32_t owner : step.RemovedOwners)
+				bodies.erase(owner);
+
+			for (const BodyRecord &edit : step.Edits)
+			{
+				std::unique_ptr<ReplayBody> &replayBody = bodies[edit.OwnerEntityID];
+				if (!replayBody)
+				{
+					replayBody = std::make_unique<ReplayBody>();
+					replayBody->Instance.SetEntityOwnerID(edit.OwnerEntityID);
+					world.AddBody(&replayBody->Instance);
+				}
+
+				// Same setters the game goes through, so bodies wake up the same way
+				Body &body = replayBody->Instance;
+				if (!replayBody->Shape || !(replayBody->ShapeRecord == edit.Collider))
+				{
+					replayBody->Shape = CreateCollider(edit.Collider);
+					replayBody->ShapeRecord = edit.Collider;
+					body.SetCollider(replayBody->Shape.get());
+				}
+				body.SetType(edit.Type);
+				body.SetPosition(edit.Position);
+				body.SetVelocity(edit.Velocity);
+				body.SetForce(edit.Force);
+				body.SetContinuousCollision(edit.ContinuousCollision);
+				body.SetCollisionFilter(edit.Filter);
+
+				uint32_t index = store.IndexOf(body.GetHandle());
+				store.InverseMasses[index] = edit.InverseMass;
+				if (edit.Awake && !body.IsAwake())
+					store.Wake(index);
+				else if (!edit.Awake && body.IsAwake())
+					store.Sleep(index);
+			}
+
+			world.Step(step.TimeStep);
+
+			uint64_t hash = world.GetStepHash();
+			if (hash != step.Hash)
+			{
+				result.FirstMismatch = result.StepsReplayed;
+				result.Expected = step.Hash;
+				result.Actual = hash;
+				break;
+			}
+			result.StepsReplayed++;
+		}
+
+		bodies.clear();
+		world.Clear();
+		return result;
+	}
+}
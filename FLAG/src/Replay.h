@@ -0,0 +1,97 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Physics.h"
+
+namespace flg
+{
+    // Collider parameters by value so a recording does not point into the recorded process
+    struct ColliderRecord
+    {
+        ColliderType Type = ColliderType::None;
+        glm::vec3 Center{0.0f}; // Sphere center, plane or ray origin
+        glm::vec3 Normal{0.0f}; // Plane normal or ray direction
+        glm::vec2 Bounds{0.0f};
+        float Radius = 0.0f;
+
+        bool operator==(const ColliderRecord &other) const;
+    };
+
+    struct BodyRecord
+    {
+        uint32_t OwnerEntityID = -1;
+        glm::vec3 Position{0.0f};
+        glm::vec3 Velocity{0.0f};
+        glm::vec3 Force{0.0f};
+        float InverseMass = 0.0f; // Not the mass, which does not survive the round trip bit exact
+        BodyType Type = BodyType::Static;
+        bool Awake = false;
+        bool ContinuousCollision = false;
+        CollisionFilter Filter;
+        ColliderRecord Collider;
+
+        bool operator==(const BodyRecord &other) const;
+    };
+
+    // Everything done to the world between the previous step and this one, and the state hash after it
+    struct StepRecord
+    {
+        float TimeStep = 0.0f;
+        std::vector<BodyRecord> Edits;      // Added or changed bodies, sorted by owner
+        std::vector<uint32_t> RemovedOwners; // Sorted
+        uint64_t Hash = 0;
+    };
+
+    // Steps recorded with PhysicsWorld::StartRecording. Bodies are matched by owner entity ID, which has to be unique
+    // while recording. Changes made from collision callbacks happen inside a step and are not captured.
+    class PhysicsRecording
+    {
+    public:
+        bool Save(const std::string &path) const;
+        bool Load(const std::string &path);
+        void Clear();
+
+        // Called by the world around every recorded step
+        void BeginStep(const BodyStore &bodies, float dt);
+        void EndStep(const BodyStore &bodies, uint64_t hash);
+
+    public:
+        PhysicsWorldProperties Properties;
+        std::vector<StepRecord> Steps;
+
+    private:
+        struct KnownBody
+        {
+            BodyRecord Record;
+            uint32_t Seen = 0;
+        };
+
+        // Body state after the last recorded step, edits are the differences to it
+        std::unordered_map<uint32_t, KnownBody> m_Known;
+        uint32_t m_Stamp = 0;
+    };
+
+    struct ReplayResult
+    {
+        uint32_t StepsReplayed = 0;
+        int64_t FirstMismatch = -1; // Step whose hash differs, -1 if every step matched
+        uint64_t Expected = 0;
+        uint64_t Actual = 0;
+
+        bool Matched() const { return FirstMismatch < 0; }
+    };
+
+    // Clears the world and steps it through the recording, stopping at the first hash mismatch.
+    // The world keeps its thread count since results do not depend on it.
+    ReplayResult ReplayRecording(PhysicsWorld &world, const PhysicsRecording &recording);
+}
+
+#endif
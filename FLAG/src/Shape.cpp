@@ -0,0 +1,168 @@
+#include "Shape.h"
+#include "Algorithms.h"
+
+namespace flg
+{
+	Shape Shape::FromCollider(const Collider *collider)
+	{
+		Shape shape;
+		if (collider == nullptr)
+			return shape;
+
+		shape.Type = collider->Type;
+		switch (collider->Type)
+		{
+		case ColliderType::Sphere:
+		{
+			const SphereCollider *sphere = static_cast<const SphereCollider *>(collider);
+			shape.Sphere = SphereShape{sphere->Center, sphere->Radius};
+			break;
+		}
+		case ColliderType::Plane:
+		{
+			const PlaneCollider *plane = static_cast<const PlaneCollider *>(collider);
+			shape.Plane = PlaneShape{plane->Origin, plane->Normal, plane->Bounds};
+			break;
+		}
+		case ColliderType::Ray:
+		{
+			const flg::Ray *ray = static_cast<const flg::Ray *>(collider);
+			shape.Ray = RayShape{ray->Origin, ray->Direction};
+			break;
+		}
+		default:
+			break;
+		}
+		return shape;
+	}
+
+	bool ComputeShapeAABB(const Shape &shape, const glm::vec3 &position, AABB &aabb)
+	{
+		if (shape.Type == ColliderType::Sphere)
+		{
+			glm::vec3 worldCenter = position + shape.Sphere.Center;
+			aabb.Min = worldCenter - glm::vec3{shape.Sphere.Radius};
+			aabb.Max = worldCenter + glm::vec3{shape.Sphere.Radius};
+			return true;
+		}
+
+		// Finite planes are a rectangle around their origin
+		if (shape.Type == ColliderType::Plane && shape.Plane.Bounds.x > 0.0f && shape.Plane.Bounds.y > 0.0f && glm::length(shape.Plane.Normal) > 0.0f)
+		{
+			glm::vec3 tangentU, tangentV;
+			algo::FindPlaneTangents(glm::normalize(shape.Plane.Normal), tangentU, tangentV);
+			glm::vec3 extent = glm::abs(tangentU) * shape.Plane.Bounds.x + glm::abs(tangentV) * shape.Plane.Bounds.y;
+			glm::vec3 worldOrigin = position + shape.Plane.Origin;
+			aabb.Min = worldOrigin - extent;
+			aabb.Max = worldOrigin + extent;
+			return true;
+		}
+
+		return false;
+	}
+
+	// --- Narrowphase Routines ---
+	// The Collider double dispatch calls B's overload for A's type, so sphere pairs come out as B - A and
+	// sphere plane pairs report the plane's point first
+	static CollisionPoints SphereSphere(const Shape &a, const glm::vec3 &positionA, const Shape &b, const glm::vec3 &positionB)
+	{
+		return algo::FindSphereSphereColissionPoints(positionB + b.Sphere.Center, b.Sphere.Radius, positionA + a.Sphere.Center, a.Sphere.Radius);
+	}
+
+	// Rays are tested where they are defined, their own transform is ignored
+	static CollisionPoints RaySphere(const Shape &a, const glm::vec3 &, const Shape &b, const glm::vec3 &positionB)
+	{
+		return algo::FindRaySphereCollisionPoints(a.Ray.Origin, a.Ray.Direction, positionB + b.Sphere.Center, b.Sphere.Radius);
+	}
+
+	static CollisionPoints SpherePlane(const Shape &a, const glm::vec3 &positionA, const Shape &b, const glm::vec3 &positionB)
+	{
+		return algo::FindPlaneSphereCollissionPoints(positionB + b.Plane.Origin, b.Plane.Normal, b.Plane.Bounds, positionA + a.Sphere.Center, a.Sphere.Radius);
+	}
+
+	static CollisionPoints PlaneSphere(const Shape &a, const glm::vec3 &positionA, const Shape &b, const glm::vec3 &positionB)
+	{
+		return algo::FindSpherePlaneCollissionPoints(positionB + b.Sphere.Center, b.Sphere.Radius, positionA + a.Plane.Origin, a.Plane.Normal, a.Plane.Bounds);
+	}
+
+	static CollisionPoints RayPlane(const Shape &a, const glm::vec3 &, const Shape &b, const glm::vec3 &)
+	{
+		return algo::FindRayPlaneCollisionPoints(a.Ray.Origin, a.Ray.Direction, b.Plane.Origin, b.Plane.Normal);
+	}
+
+	// Indexed [A][B] by ColliderType. Empty entries match the overloads that return no collision.
+	static const ShapeCollisionFn s_CollisionTable[SHAPE_TYPE_COUNT][SHAPE_TYPE_COUNT] = {
+		//  None     Sphere        Plane        Ray
+		{nullptr, nullptr, nullptr, nullptr},		   // None
+		{nullptr, SphereSphere, SpherePlane, nullptr}, // Sphere
+		{nullptr, PlaneSphere, nullptr, nullptr},	   // Plane
+		{nullptr, RaySphere, RayPlane, nullptr},	   // Ray
+	};
+
+	ShapeCollisionFn GetShapeCollisionFn(ColliderType a, ColliderType b)
+	{
+		return s_CollisionTable[static_cast<uint32_t>(a)][static_cast<uint32_t>(b)];
+	}
+
+	bool ComputeShapeContact(const Shape &a, const glm::vec3 &positionA, const Shape &b, const glm::vec3 &positionB, glm::vec3 &normal, float &depth)
+	{
+		if (a.Type == ColliderType::Sphere && b.Type == ColliderType::Sphere)
+		{
+			glm::vec3 delta = (positionB + b.Sphere.Center) - (positionA + a.Sphere.Center);
+			float distance = glm::length(delta);
+			depth = a.Sphere.Radius + b.Sphere.Radius - distance;
+
+			// Concentric spheres have no direction to separate in, push along y
+			normal = distance > 0.0f ? delta / distance : glm::vec3{0.0f, 1.0f, 0.0f};
+			return depth > 0.0f;
+		}
+
+		// The plane pushes the sphere out, so the normal from the sphere to the plane points against that
+		if (a.Type == ColliderType::Sphere && b.Type == ColliderType::Plane)
+		{
+			bool touching = algo::FindSpherePlaneContact(positionA + a.Sphere.Center, a.Sphere.Radius, positionB + b.Plane.Origin, b.Plane.Normal, b.Plane.Bounds, normal, depth);
+			normal = -normal;
+			return touching;
+		}
+
+		if (a.Type == ColliderType::Plane && b.Type == ColliderType::Sphere)
+			return algo::FindSpherePlaneContact(positionB + b.Sphere.Center, b.Sphere.Radius, positionA + a.Plane.Origin, a.Plane.Normal, a.Plane.Bounds, normal, depth);
+
+		return false;
+	}
+
+	bool SweepShape(const Shape &moving, const glm::vec3 &start, const glm::vec3 &motion, const Shape &other, const glm::vec3 &otherPosition,
+					float &t, glm::vec3 &normal)
+	{
+		if (moving.Type != ColliderType::Sphere)
+			return false;
+
+		const glm::vec3 startCenter = start + moving.Sphere.Center;
+		if (other.Type == ColliderType::Sphere)
+		{
+			const glm::vec3 otherCenter = otherPosition + other.Sphere.Center;
+			if (!algo::FindSweptSphereSphereTime(startCenter, motion, moving.Sphere.Radius, otherCenter, other.Sphere.Radius, t))
+				return false;
+
+			normal = glm::normalize(otherCenter - (startCenter + motion * t));
+			return true;
+		}
+
+		if (other.Type == ColliderType::Plane)
+		{
+			if (!algo::FindSweptSpherePlaneTime(startCenter, motion, moving.Sphere.Radius, otherPosition + other.Plane.Origin, other.Plane.Normal, other.Plane.Bounds, t))
+				return false;
+
+			normal = -glm::normalize(other.Plane.Normal);
+			return true;
+		}
+
+		return false;
+	}
+
+	CollisionPoints TestShapeCollision(const Shape &a, const glm::vec3 &positionA, const Shape &b, const glm::vec3 &positionB)
+	{
+		ShapeCollisionFn fn = GetShapeCollisionFn(a.Type, b.Type);
+		return fn ? fn(a, positionA, b, positionB) : CollisionPoints{};
+	}
+}
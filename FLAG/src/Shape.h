@@ -0,0 +1,73 @@
+#ifndef SHAPE_H
+#define SHAPE_H
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+
+#include "Collider.h"
+
+namespace flg
+{
+    struct SphereShape
+    {
+        glm::vec3 Center;
+        float Radius;
+    };
+
+    struct PlaneShape
+    {
+        glm::vec3 Origin;
+        glm::vec3 Normal;
+        glm::vec2 Bounds;
+    };
+
+    struct RayShape
+    {
+        glm::vec3 Origin;
+        glm::vec3 Direction;
+    };
+
+    // Collider data by value behind a type tag, what the world's narrowphase works on.
+    // Colliders are copied into shapes so pair tests need neither virtual calls nor pointer chasing.
+    struct Shape
+    {
+        ColliderType Type = ColliderType::None;
+        union
+        {
+            SphereShape Sphere;
+            PlaneShape Plane;
+            RayShape Ray;
+        };
+
+        Shape() : Plane{glm::vec3{0.0f}, glm::vec3{0.0f}, glm::vec2{0.0f}} {}
+
+        static Shape FromCollider(const Collider *collider);
+    };
+
+    // Returns false if the shape has no finite bounds (i.e may collide with anything)
+    bool ComputeShapeAABB(const Shape &shape, const glm::vec3 &position, AABB &aabb);
+
+    // Narrowphase routine for one combination of shape types. Points follow the Collider double dispatch, i.e
+    // sphere pairs report (B - A) / 2 and ray tests report the hit point.
+    using ShapeCollisionFn = CollisionPoints (*)(const Shape &a, const glm::vec3 &positionA, const Shape &b, const glm::vec3 &positionB);
+
+    static constexpr uint32_t SHAPE_TYPE_COUNT = 4;
+
+    // Entry of the (A, B) dispatch table, nullptr for combinations that never collide
+    ShapeCollisionFn GetShapeCollisionFn(ColliderType a, ColliderType b);
+
+    CollisionPoints TestShapeCollision(const Shape &a, const glm::vec3 &positionA, const Shape &b, const glm::vec3 &positionB);
+
+    // Fraction of the motion after which a sphere moving from start first touches the other shape, and the contact normal
+    // (pointing from the moving shape to the other) at that time. Returns false for misses and shapes that already touch.
+    bool SweepShape(const Shape &moving, const glm::vec3 &start, const glm::vec3 &motion, const Shape &other, const glm::vec3 &otherPosition,
+                    float &t, glm::vec3 &normal);
+
+    // Contact normal (pointing from A to B) and penetration depth for the solver.
+    // Returns false for shapes that do not touch or that get no collision response (i.e rays).
+    bool ComputeShapeContact(const Shape &a, const glm::vec3 &positionA, const Shape &b, const glm::vec3 &positionB, glm::vec3 &normal, float &depth);
+}
+
+#endif
@@ -0,0 +1,106 @@
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+namespace flg
+{
+	WorkerPool::WorkerPool(uint32_t threadCount)
+	{
+		if (threadCount == 0)
+			threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+		for (uint32_t worker = 1; worker < threadCount; worker++)
+			m_Threads.emplace_back(&WorkerPool::WorkerLoop, this, worker);
+	}
+
+	WorkerPool::WorkerPool(TaskExecutor *executor)
+		: m_Executor(executor)
+	{
+	}
+
+	WorkerPool::~WorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Stop = true;
+		}
+		m_WakeCondition.notify_all();
+
+		for (std::thread &thread : m_Threads)
+			thread.join();
+	}
+
+	void WorkerPool::ParallelFor(uint32_t count, uint32_t minRange, const RangeFn &fn)
+	{
+		if (count == 0)
+			return;
+
+		if (m_Executor)
+		{
+			m_Executor->ParallelFor(count, minRange, fn);
+			return;
+		}
+
+		// A few ranges per thread so uneven ranges even out
+		const uint32_t threadCount = GetThreadCount();
+		const uint32_t rangeSize = std::max(std::max(minRange, 1u), (count + threadCount * 4 - 1) / (threadCount * 4));
+		if (m_Threads.empty() || rangeSize >= count)
+		{
+			fn(0, count, 0);
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Job = &fn;
+			m_JobCount = count;
+			m_RangeSize = rangeSize;
+			m_NextIndex = 0;
+			m_Busy = static_cast<uint32_t>(m_Threads.size());
+			m_Generation++;
+		}
+		m_WakeCondition.notify_all();
+
+		RunRanges(0);
+
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_DoneCondition.wait(lock, [this]
+							 { return m_Busy == 0; });
+		m_Job = nullptr;
+	}
+
+	void WorkerPool::WorkerLoop(uint32_t worker)
+	{
+		uint64_t generation = 0;
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_WakeCondition.wait(lock, [this, generation]
+									 { return m_Stop || m_Generation != generation; });
+				if (m_Stop)
+					return;
+
+				generation = m_Generation;
+			}
+
+			RunRanges(worker);
+
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (--m_Busy == 0)
+				m_DoneCondition.notify_one();
+		}
+	}
+
+	void WorkerPool::RunRanges(uint32_t worker)
+	{
+		while (true)
+		{
+			uint32_t begin = m_NextIndex.fetch_add(m_RangeSize);
+			if (begin >= m_JobCount)
+				return;
+
+			(*m_Job)(begin, std::min(begin + m_RangeSize, m_JobCount), worker);
+		}
+	}
+}
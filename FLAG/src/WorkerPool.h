@@ -0,0 +1,74 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace flg
+{
+    // worker is in [0, GetThreadCount()) of whoever runs the range, 0 being the calling thread
+    using RangeFn = std::function<void(uint32_t begin, uint32_t end, uint32_t worker)>;
+
+    // Lets a host engine run the ranges on its own threads instead of a pool owning threads of its own.
+    // Ranges running at the same time must get different worker indices, and GetThreadCount has to stay the same while a pool uses the executor.
+    class TaskExecutor
+    {
+    public:
+        virtual ~TaskExecutor() = default;
+
+        virtual uint32_t GetThreadCount() const = 0;
+
+        // Runs fn over [0, count) in ranges of at least minRange items. Returns once every range is done.
+        virtual void ParallelFor(uint32_t count, uint32_t minRange, const RangeFn &fn) = 0;
+    };
+
+    // Fixed set of threads that split index ranges between them.
+    // The calling thread works too, so a pool of one thread runs everything inline.
+    class WorkerPool
+    {
+    public:
+        using RangeFn = flg::RangeFn;
+
+        // threadCount of 0 uses one thread per hardware thread
+        WorkerPool(uint32_t threadCount = 1);
+        // Hands every ParallelFor to executor and starts no threads, the executor has to outlive the pool
+        explicit WorkerPool(TaskExecutor *executor);
+        WorkerPool(const WorkerPool &other) = delete;
+        WorkerPool &operator=(const WorkerPool &other) = delete;
+        ~WorkerPool();
+
+        uint32_t GetThreadCount() const { return m_Executor ? m_Executor->GetThreadCount() : static_cast<uint32_t>(m_Threads.size()) + 1; }
+
+        // Runs fn over [0, count) in ranges of at least minRange items. Returns once every range is done.
+        void ParallelFor(uint32_t count, uint32_t minRange, const RangeFn &fn);
+
+    private:
+        void WorkerLoop(uint32_t worker);
+        void RunRanges(uint32_t worker);
+
+    private:
+        TaskExecutor *m_Executor = nullptr;
+        std::vector<std::thread> m_Threads;
+        std::mutex m_Mutex;
+        std::condition_variable m_WakeCondition;
+        std::condition_variable m_DoneCondition;
+        bool m_Stop = false;
+
+        // Current job, written under m_Mutex before workers are woken
+        const RangeFn *m_Job = nullptr;
+        uint32_t m_JobCount = 0;
+        uint32_t m_RangeSize = 0;
+        uint64_t m_Generation = 0;
+        uint32_t m_Busy = 0;
+        std::atomic<uint32_t> m_NextIndex{0};
+    };
+}
+
+#endif
@@ -0,0 +1,135 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include "Core/JobSystem.h"
+#include "Scene/Scene.h"
+
+// World transform pass over flat and parented scenes, timed through Scene::Update. The scenes hold no renderers
+// or scripts, so an update is the transform pass plus an empty command playback and needs no window.
+
+class Timer
+{
+public:
+	Timer() { Reset(); }
+
+	void Reset() { m_Start = std::chrono::high_resolution_clock::now(); }
+	double ElapsedSeconds() const
+	{
+		return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - m_Start).count();
+	}
+
+private:
+	std::chrono::high_resolution_clock::time_point m_Start;
+};
+
+struct BenchScene
+{
+	SGE::Scene Scene;
+	std::vector<entt::entity> Roots;
+	std::vector<entt::entity> Leaves;
+};
+
+// Roots with chains of depth entities below them, every entity in a chain having childrenPerNode children
+static void BuildTrees(BenchScene &bench, uint32_t rootCount, uint32_t depth, uint32_t childrenPerNode)
+{
+	for (uint32_t root = 0; root < rootCount; root++)
+	{
+		SGE::Entity rootEntity = bench.Scene.CreateEntity("root", glm::vec3(static_cast<float>(root), 0.0f, 0.0f));
+		bench.Roots.push_back(static_cast<entt::entity>(rootEntity.Id()));
+
+		std::vector<SGE::Entity> level = {rootEntity};
+		for (uint32_t d = 0; d < depth; d++)
+		{
+			std::vector<SGE::Entity> next;
+			for (SGE::Entity parent : level)
+			{
+				for (uint32_t c = 0; c < childrenPerNode; c++)
+				{
+					SGE::Entity child = bench.Scene.CreateEntity("child", glm::vec3(0.0f, 1.0f, 0.0f));
+					child.GetComponent<SGE::TransformComponent>().Rotation = glm::vec3(0.0f, 0.1f, 0.0f);
+					bench.Scene.SetParent(child, parent);
+					next.push_back(child);
+				}
+			}
+			level.swap(next);
+		}
+
+		for (SGE::Entity leaf : level)
+			bench.Leaves.push_back(static_cast<entt::entity>(leaf.Id()));
+	}
+}
+
+// Average update time over frames, move runs before every update
+static double TimeUpdates(BenchScene &bench, uint32_t frames, const std::function<void(uint32_t)> &move)
+{
+	// The first update builds the hierarchy order and every matrix
+	bench.Scene.Update(SGE::TimeStep(0.016f));
+
+	Timer timer;
+	for (uint32_t frame = 0; frame < frames; frame++)
+	{
+		move(frame);
+		bench.Scene.Update(SGE::TimeStep(0.016f));
+	}
+	return timer.ElapsedSeconds() / frames;
+}
+
+static void RunScene(const char *name, uint32_t rootCount, uint32_t depth, uint32_t childrenPerNode)
+{
+	const uint32_t frames = 50;
+
+	BenchScene bench;
+	BuildTrees(bench, rootCount, depth, childrenPerNode);
+	entt::registry &registry = bench.Scene.Registry();
+	const size_t entityCount = registry.storage<SGE::TransformComponent>().size();
+
+	double staticSeconds = TimeUpdates(bench, frames, [](uint32_t) {});
+
+	double rootSeconds = TimeUpdates(bench, frames, [&](uint32_t frame)
+									 {
+		for (entt::entity root : bench.Roots)
+			registry.get<SGE::TransformComponent>(root).Position.y = static_cast<float>(frame); });
+
+	// One in a hundred leaves, what animated attachments on otherwise still objects look like
+	double leafSeconds = TimeUpdates(bench, frames, [&](uint32_t frame)
+									 {
+		for (size_t i = 0; i < bench.Leaves.size(); i += 100)
+			registry.get<SGE::TransformComponent>(bench.Leaves[i]).Rotation.x = static_cast<float>(frame) * 0.01f; });
+
+	printf("%-10s %6u %6u %6u %10zu %12.3f %12.3f %12.3f\n", name, rootCount, depth, childrenPerNode, entityCount,
+		   staticSeconds * 1000.0, rootSeconds * 1000.0, leafSeconds * 1000.0);
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t threadCount = 0;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+		{
+			threadCount = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+		}
+		else
+		{
+			printf("usage: sge_bench [--threads N]\n");
+			return 1;
+		}
+	}
+
+	SGE::JobSystem::Init(threadCount);
+	printf("threads %u\n\n", SGE::JobSystem::GetThreadCount());
+
+	printf("%-10s %6s %6s %6s %10s %12s %12s %12s\n", "scene", "roots", "depth", "fanout", "entities", "static ms", "roots ms", "leaves ms");
+	RunScene("flat", 100000, 0, 0);
+	RunScene("wide", 1, 1, 100000);
+	RunScene("forest", 1000, 1, 100);
+	RunScene("deep", 100, 1000, 1);
+	RunScene("bushy", 100, 4, 6);
+
+	SGE::JobSystem::Shutdown();
+	return 0;
+}
@@ -6,6 +6,7 @@
 #include "Renderer/Renderer.h"
 #include "ImGui/ImGuiLayer.h"
 
+#include "Core/JobSystem.h"
 #include "Core/TimeStep.h"
 #include "Core/Input.h"
 
@@ -20,6 +21,8 @@ namespace SGE
 		assert(!s_Instance);
 		s_Instance = this;
 
+		JobSystem::Init();
+
 		m_Window = std::unique_ptr<Window>(Window::CreateWindow());
 		m_Window->SetEventCallBack(std::bind(&Application::OnEvent, this, std::placeholders::_1));
 
@@ -29,7 +32,10 @@ namespace SGE
 		PushOverlay(m_ImGuiLayer);
 	}
 
-	Application::~Application() {}
+	Application::~Application()
+	{
+		JobSystem::Shutdown();
+	}
 
 	void Application::Update(TimeStep timestep)
 	{
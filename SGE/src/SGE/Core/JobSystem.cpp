@@ -0,0 +1,294 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "WorkerPool.h"
+
+namespace SGE
+{
+	struct JobState
+	{
+		JobSystem::JobFn Fn;
+		std::atomic<uint32_t> PendingDependencies{0};
+		std::atomic<bool> Done{false};
+
+		// Guards Dependents, and Done against a dependent being added while the job finishes
+		std::mutex Mutex;
+		std::vector<Ref<JobState>> Dependents;
+	};
+
+	struct WorkerQueue
+	{
+		std::mutex Mutex;
+		std::deque<Ref<JobState>> Jobs;
+	};
+
+	// Runs physics ranges as jobs, the world sizes its per worker scratch from GetThreadCount
+	class JobSystemExecutor : public flg::TaskExecutor
+	{
+	public:
+		uint32_t GetThreadCount() const override { return JobSystem::GetThreadCount(); }
+		void ParallelFor(uint32_t count, uint32_t minRange, const flg::RangeFn &fn) override { JobSystem::ParallelFor(count, minRange, fn); }
+	};
+
+	bool JobSystem::s_Running = false;
+
+	static std::vector<std::thread> s_Threads;
+	static std::vector<Scope<WorkerQueue>> s_Queues; // One per thread, 0 being the main thread
+	static std::atomic<uint32_t> s_QueuedCount{0};
+	static std::mutex s_SleepMutex;
+	static std::condition_variable s_WakeCondition;
+	static bool s_Stop = false;
+	static JobSystemExecutor s_Executor;
+
+	static thread_local uint32_t t_WorkerIndex = 0;
+
+	static void Push(const Ref<JobState> &job)
+	{
+		{
+			WorkerQueue &queue = *s_Queues[t_WorkerIndex];
+			std::lock_guard<std::mutex> lock(queue.Mutex);
+			queue.Jobs.push_back(job);
+		}
+
+		// Counted before taking the lock so a worker about to sleep either sees the job or gets the notification
+		s_QueuedCount++;
+		{
+			std::lock_guard<std::mutex> lock(s_SleepMutex);
+		}
+		s_WakeCondition.notify_one();
+	}
+
+	static void Execute(const Ref<JobState> &job)
+	{
+		job->Fn();
+		job->Fn = nullptr;
+
+		std::vector<Ref<JobState>> dependents;
+		{
+			std::lock_guard<std::mutex> lock(job->Mutex);
+			job->Done = true;
+			dependents.swap(job->Dependents);
+		}
+
+		for (const Ref<JobState> &dependent : dependents)
+		{
+			if (--dependent->PendingDependencies == 0)
+				Push(dependent);
+		}
+	}
+
+	// Newest job of the worker's own queue first, then the oldest job of the next queue that has one
+	static bool TryRunJob(uint32_t worker)
+	{
+		const uint32_t queueCount = static_cast<uint32_t>(s_Queues.size());
+		for (uint32_t i = 0; i < queueCount; i++)
+		{
+			WorkerQueue &queue = *s_Queues[(worker + i) % queueCount];
+			Ref<JobState> job;
+			{
+				std::lock_guard<std::mutex> lock(queue.Mutex);
+				if (queue.Jobs.empty())
+					continue;
+
+				if (i == 0)
+				{
+					job = std::move(queue.Jobs.back());
+					queue.Jobs.pop_back();
+				}
+				else
+				{
+					job = std::move(queue.Jobs.front());
+					queue.Jobs.pop_front();
+				}
+			}
+
+			s_QueuedCount--;
+			Execute(job);
+			return true;
+		}
+		return false;
+	}
+
+	static void WorkerLoop(uint32_t worker)
+	{
+		t_WorkerIndex = worker;
+		while (true)
+		{
+			if (TryRunJob(worker))
+				continue;
+
+			std::unique_lock<std::mutex> lock(s_SleepMutex);
+			if (s_Stop && s_QueuedCount == 0)
+				return;
+
+			s_WakeCondition.wait(lock, []
+								 { return s_Stop || s_QueuedCount > 0; });
+		}
+	}
+
+	// A few ranges per thread so uneven ranges even out
+	static uint32_t RangeSize(uint32_t count, uint32_t minRange)
+	{
+		const uint32_t threadCount = JobSystem::GetThreadCount();
+		return std::max(std::max(minRange, 1u), (count + threadCount * 4 - 1) / (threadCount * 4));
+	}
+
+	bool JobHandle::IsDone() const
+	{
+		return !m_State || m_State->Done;
+	}
+
+	void JobSystem::Init(uint32_t threadCount)
+	{
+		assert(!s_Running);
+		if (threadCount == 0)
+			threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+		s_Stop = false;
+		for (uint32_t worker = 0; worker < threadCount; worker++)
+			s_Queues.push_back(CreateScope<WorkerQueue>());
+		for (uint32_t worker = 1; worker < threadCount; worker++)
+			s_Threads.emplace_back(WorkerLoop, worker);
+
+		s_Running = true;
+	}
+
+	void JobSystem::Shutdown()
+	{
+		if (!s_Running)
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(s_SleepMutex);
+			s_Stop = true;
+		}
+		s_WakeCondition.notify_all();
+
+		for (std::thread &thread : s_Threads)
+			thread.join();
+		s_Threads.clear();
+
+		// Whatever the main thread queued last, there are no workers left to steal it
+		while (TryRunJob(0))
+			;
+
+		s_Queues.clear();
+		s_Running = false;
+	}
+
+	uint32_t JobSystem::GetThreadCount()
+	{
+		return s_Running ? static_cast<uint32_t>(s_Queues.size()) : 1;
+	}
+
+	uint32_t JobSystem::GetWorkerIndex()
+	{
+		return t_WorkerIndex;
+	}
+
+	JobHandle JobSystem::Schedule(JobFn job, const std::vector<JobHandle> &dependencies)
+	{
+		Ref<JobState> state = CreateRef<JobState>();
+		if (!s_Running)
+		{
+			// Nothing can still be pending, every job so far ran when it was scheduled
+			job();
+			state->Done = true;
+			return JobHandle(state);
+		}
+
+		state->Fn = std::move(job);
+
+		// One extra count held until every dependency is registered, so the job cannot be queued half way through
+		const uint32_t held = static_cast<uint32_t>(dependencies.size()) + 1;
+		state->PendingDependencies = held;
+		uint32_t released = 1;
+		for (const JobHandle &dependency : dependencies)
+		{
+			if (!dependency.m_State)
+			{
+				released++;
+				continue;
+			}
+
+			std::lock_guard<std::mutex> lock(dependency.m_State->Mutex);
+			if (dependency.m_State->Done)
+				released++;
+			else
+				dependency.m_State->Dependents.push_back(state);
+		}
+
+		if (state->PendingDependencies.fetch_sub(released) == released)
+			Push(state);
+
+		return JobHandle(state);
+	}
+
+	JobHandle JobSystem::Combine(const std::vector<JobHandle> &handles)
+	{
+		return Schedule([] {}, handles);
+	}
+
+	void JobSystem::Wait(const JobHandle &handle)
+	{
+		while (!handle.IsDone())
+		{
+			if (!s_Running || !TryRunJob(t_WorkerIndex))
+				std::this_thread::yield();
+		}
+	}
+
+	JobHandle JobSystem::ScheduleParallelFor(uint32_t count, uint32_t minRange, RangeFn fn, const std::vector<JobHandle> &dependencies)
+	{
+		const uint32_t rangeSize = RangeSize(count, minRange);
+
+		// Shared by the ranges and released with the last of them
+		Ref<RangeFn> shared = CreateRef<RangeFn>(std::move(fn));
+		std::vector<JobHandle> ranges;
+		for (uint32_t begin = 0; begin < count; begin += rangeSize)
+		{
+			const uint32_t end = std::min(begin + rangeSize, count);
+			ranges.push_back(Schedule([shared, begin, end]
+									  { (*shared)(begin, end, t_WorkerIndex); },
+									  dependencies));
+		}
+		return Combine(ranges);
+	}
+
+	void JobSystem::ParallelFor(uint32_t count, uint32_t minRange, const RangeFn &fn)
+	{
+		if (count == 0)
+			return;
+
+		const uint32_t rangeSize = RangeSize(count, minRange);
+		if (GetThreadCount() == 1 || rangeSize >= count)
+		{
+			fn(0, count, t_WorkerIndex);
+			return;
+		}
+
+		// fn outlives the ranges since this only returns once they are done, so they can refer to it directly
+		std::vector<JobHandle> ranges;
+		for (uint32_t begin = 0; begin < count; begin += rangeSize)
+		{
+			const uint32_t end = std::min(begin + rangeSize, count);
+			ranges.push_back(Schedule([&fn, begin, end]
+									  { fn(begin, end, t_WorkerIndex); }));
+		}
+
+		for (const JobHandle &range : ranges)
+			Wait(range);
+	}
+
+	flg::TaskExecutor *JobSystem::GetTaskExecutor()
+	{
+		return &s_Executor;
+	}
+}
@@ -0,0 +1,89 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "Core/Core.h"
+
+namespace flg
+{
+    class TaskExecutor;
+}
+
+namespace SGE
+{
+    struct JobState;
+
+    // Handle to a scheduled job. Default constructed handles count as finished jobs.
+    class JobHandle
+    {
+    public:
+        JobHandle() = default;
+
+        bool IsValid() const { return m_State != nullptr; }
+        bool IsDone() const;
+
+    private:
+        explicit JobHandle(const Ref<JobState> &state) : m_State(state) {}
+
+        friend class JobSystem;
+        Ref<JobState> m_State;
+    };
+
+    // Engine wide work-stealing thread pool, started and stopped by Application.
+    // Every worker has its own queue and takes from the others when it runs dry. Threads waiting on a job run other jobs
+    // in the meantime, so jobs can schedule and wait on jobs of their own. Use it from the main thread and from jobs.
+    class JobSystem
+    {
+    public:
+        using JobFn = std::function<void()>;
+        // worker is in [0, GetThreadCount()), 0 being the main thread
+        using RangeFn = std::function<void(uint32_t begin, uint32_t end, uint32_t worker)>;
+
+        // threadCount counts the main thread, 0 uses one thread per hardware thread. The count stays fixed until Shutdown.
+        static void Init(uint32_t threadCount = 0);
+        // Finishes every queued job before the workers stop
+        static void Shutdown();
+
+        static bool IsRunning() { return s_Running; }
+        static uint32_t GetThreadCount();
+        static uint32_t GetWorkerIndex();
+
+        // Queues job to run once every dependency finished. Before Init the job runs right away.
+        // Without worker threads jobs only run inside Wait.
+        static JobHandle Schedule(JobFn job, const std::vector<JobHandle> &dependencies = {});
+        // Handle that finishes once every one of handles did
+        static JobHandle Combine(const std::vector<JobHandle> &handles);
+        static void Wait(const JobHandle &handle);
+
+        // Runs fn over [0, count) in ranges of at least minRange items. Ranges running at the same time get different
+        // worker indices, unless a range itself waits on jobs.
+        static JobHandle ScheduleParallelFor(uint32_t count, uint32_t minRange, RangeFn fn, const std::vector<JobHandle> &dependencies = {});
+        // Same but returns once every range is done, the calling thread takes ranges too
+        static void ParallelFor(uint32_t count, uint32_t minRange, const RangeFn &fn);
+
+        // Calls fn(entity) for every entity of an entt view. Only touch the components of the entity passed in,
+        // and leave adding or removing components and entities until the loop returned.
+        template <typename View, typename Fn>
+        static void ParallelForEach(const View &view, uint32_t minRange, Fn fn)
+        {
+            const std::vector<typename View::entity_type> entities(view.begin(), view.end());
+            ParallelFor(static_cast<uint32_t>(entities.size()), minRange, [&entities, &fn](uint32_t begin, uint32_t end, uint32_t)
+                        {
+                for (uint32_t i = begin; i < end; i++)
+                    fn(entities[i]); });
+        }
+
+        // Runs a physics world's parallel work on these threads, see flg::PhysicsWorld::SetTaskExecutor
+        static flg::TaskExecutor *GetTaskExecutor();
+
+    private:
+        static bool s_Running;
+    };
+}
+
+#endif
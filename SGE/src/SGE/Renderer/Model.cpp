@@ -57,8 +57,13 @@ namespace SGE
 		model *= glm::eulerAngleYXZ(rotation.y, rotation.x, rotation.z);
 		model = glm::scale(model, scale);
 
+		AddInstance(model);
+	}
+
+	void Model::AddInstance(const glm::mat4 &transform)
+	{
 		glBindBuffer(GL_ARRAY_BUFFER, m_ModelTransformMatrixBuffer);
-		glBufferSubData(GL_ARRAY_BUFFER, m_NumInstances * sizeof(glm::mat4), sizeof(glm::mat4), glm::value_ptr(model));
+		glBufferSubData(GL_ARRAY_BUFFER, m_NumInstances * sizeof(glm::mat4), sizeof(glm::mat4), glm::value_ptr(transform));
 		m_NumInstances++;
 	}
 
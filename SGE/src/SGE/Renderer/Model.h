@@ -37,6 +37,7 @@ namespace SGE
 
         // - Rendering
         void AddInstance(const glm::vec3 &position = glm::vec3{1.0}, const glm::vec3 &rotation = glm::vec3{0.0f}, const glm::vec3 &scale = glm::vec3{1.0f});
+        void AddInstance(const glm::mat4 &transform);
         void Render(const Ref<Shader> shader, bool clearInstances = true);
         void DrawMesh(const Mesh &mesh);
         void Clear();
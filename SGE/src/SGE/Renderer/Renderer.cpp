@@ -102,5 +102,11 @@ namespace SGE
 		model->AddInstance(position, rotation, scale);
 	}
 
+	void Renderer::Draw(Ref<Model> model, const glm::mat4 &transform)
+	{
+		m_Models.insert(model);
+		model->AddInstance(transform);
+	}
+
 	Renderer::~Renderer() {}
 }
\ No newline at end of file
@@ -7,6 +7,7 @@ namespace SGE
 	std::unordered_map<std::string, Ref<Material>> ResourceManager::m_Materials{};
 	std::unordered_map<std::string, Ref<Model>> ResourceManager::m_Models{};
 	std::unordered_map<std::string, Ref<AnimatedModel>> ResourceManager::m_AnimatedModels{};
+	std::unordered_map<std::string, Ref<Prefab>> ResourceManager::m_Prefabs{};
 
 	Ref<Shader> ResourceManager::CreateShader(const std::string &vertexPath, const std::string &fragmentPath)
 	{
@@ -111,4 +112,21 @@ namespace SGE
 		std::cout << "ERROR::RESOURCE: Model \"" << name << "\" does not exist! \n";
 		return nullptr;
 	}
+
+	Ref<Prefab> ResourceManager::CreatePrefab(const std::string &name)
+	{
+		if (m_Prefabs.find(name) == m_Prefabs.end())
+			m_Prefabs[name] = CreateRef<Prefab>(name);
+
+		return m_Prefabs[name];
+	}
+
+	Ref<Prefab> ResourceManager::GetPrefab(const std::string &name)
+	{
+		if (m_Prefabs.find(name) != m_Prefabs.end())
+			return m_Prefabs[name];
+
+		std::cout << "ERROR::RESOURCE: Prefab \"" << name << "\" does not exist! \n";
+		return nullptr;
+	}
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include "Renderer/Shader.h"
 #include "Renderer/SkinnedMeshRenderer/AnimatedModel.h"
 #include "Renderer/Texture.h"
+#include "Scene/Prefab.h"
 
 namespace SGE {
 class ResourceManager {
@@ -36,12 +37,16 @@ public:
                                                 bool flipUVS);
   static Ref<AnimatedModel> GetAnimatedModel(const std::string &name);
 
+  static Ref<Prefab> CreatePrefab(const std::string &name);
+  static Ref<Prefab> GetPrefab(const std::string &name);
+
 private:
   static std::unordered_map<std::string, Ref<Shader>> m_Shaders;
   static std::unordered_map<std::string, Ref<Texture2D>> m_Textures;
   static std::unordered_map<std::string, Ref<Material>> m_Materials;
   static std::unordered_map<std::string, Ref<Model>> m_Models;
   static std::unordered_map<std::string, Ref<AnimatedModel>> m_AnimatedModels;
+  static std::unordered_map<std::string, Ref<Prefab>> m_Prefabs;
 
   friend class SceneSerializer;
 };
@@ -102,5 +102,11 @@ namespace SGE
 		model->AddInstance(position, rotation, scale);
 	}
 
+	void SkinnedMeshRenderer::Draw(Ref<AnimatedModel> model, const glm::mat4 &transform)
+	{
+		m_Models.insert(model);
+		model->AddInstance(transform);
+	}
+
 	SkinnedMeshRenderer::~SkinnedMeshRenderer() {}
 }
\ No newline at end of file
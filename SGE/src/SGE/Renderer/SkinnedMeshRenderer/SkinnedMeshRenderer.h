@@ -27,6 +27,8 @@ namespace SGE
 
     public:
         static void Draw(Ref<AnimatedModel> model, const glm::vec3 &position = glm::vec3(1.0f), const glm::vec3 &rotation = glm::vec3(0.0f), const glm::vec3 &scale = glm::vec3(1.0f));
+        // Already built world matrix, e.g. a WorldTransformComponent's
+        static void Draw(Ref<AnimatedModel> model, const glm::mat4 &transform);
 
     private:
         static std::unordered_set<Ref<AnimatedModel>> m_Models;
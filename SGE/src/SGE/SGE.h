@@ -4,12 +4,15 @@
 #pragma once
 
 #include "Core/Input.h"
+#include "Core/JobSystem.h"
 #include "Core/TimeStep.h"
 #include "Events/MouseEvent.h"
 
 #include "Scene/Components.h"
 #include "Scene/Entity.h"
 #include "Scene/Scene.h"
+#include "Scene/Prefab.h"
+#include "Scene/ActionQueue.h"
 
 #include "Renderer/Renderer.h"
 #include "Renderer/Shader.h"
@@ -0,0 +1,64 @@
+#ifndef ACTIONQUEUE_H
+#define ACTIONQUEUE_H
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+namespace SGE
+{
+  // Fixed capacity FIFO of plain action records, kept inside the script or component that owns it.
+  // Scripts tag their actions with an enum and switch on it when running them, so queuing an action never allocates
+  // and the queue can be processed on any job thread along with its owner.
+  template <typename Action, uint32_t Capacity>
+  class ActionQueue
+  {
+    static_assert(Capacity > 0, "ActionQueue needs room for at least one action");
+    static_assert(std::is_trivially_copyable_v<Action>, "Actions are plain records, copied in and out of the ring");
+
+  public:
+    // False when the queue is full, the action is dropped
+    bool Push(const Action &action)
+    {
+      if (Full())
+        return false;
+
+      m_Actions[(m_Head + m_Size) % Capacity] = action;
+      m_Size++;
+      return true;
+    }
+
+    // False when there was nothing queued
+    bool Pop(Action &action)
+    {
+      if (Empty())
+        return false;
+
+      action = m_Actions[m_Head];
+      m_Head = (m_Head + 1) % Capacity;
+      m_Size--;
+      return true;
+    }
+
+    const Action &Front() const { return m_Actions[m_Head]; }
+
+    void Clear()
+    {
+      m_Head = 0;
+      m_Size = 0;
+    }
+
+    bool Empty() const { return m_Size == 0; }
+    bool Full() const { return m_Size == Capacity; }
+    uint32_t Size() const { return m_Size; }
+    static constexpr uint32_t GetCapacity() { return Capacity; }
+
+  private:
+    std::array<Action, Capacity> m_Actions{};
+    uint32_t m_Head = 0;
+    uint32_t m_Size = 0;
+  };
+} // namespace SGE
+
+#endif
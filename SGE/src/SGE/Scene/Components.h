@@ -3,12 +3,15 @@
 
 #pragma once
 #include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/euler_angles.hpp>
 
 #include "Core/Core.h"
 #include "Renderer/Model.h"
 #include "Renderer/SkinnedMeshRenderer/AnimatedModel.h"
 #include "Renderer/Camera.h"
 #include "Scene/ScriptableEntity.h"
+#include "Scene/ScriptPool.h"
 #include "Events/Event.h"
 #include "Physics.h"
 
@@ -19,6 +22,42 @@ namespace SGE
       glm::vec3 Position = {0.0f, 0.0f, 0.0f};
       glm::vec3 Rotation = {0.0f, 0.0f, 0.0f};
       glm::vec3 Scale = {1.0f, 1.0f, 1.0f};
+
+      // Translate, then yaw pitch roll, then scale
+      glm::mat4 GetMatrix() const
+      {
+         glm::mat4 matrix = glm::translate(glm::mat4(1.0f), Position);
+         matrix *= glm::eulerAngleYXZ(Rotation.y, Rotation.x, Rotation.z);
+         return glm::scale(matrix, Scale);
+      }
+   };
+
+   // Cached TransformComponent::GetMatrix, added with the transform by Scene::CreateEntity. The scene's transform pass
+   // rebuilds it only when the transform differs from the one it was built from, renderers draw straight from Matrix.
+   struct WorldTransformComponent
+   {
+      glm::mat4 Matrix{1.0f};
+
+      // Set to force a rebuild on the next pass, the pass clears it
+      bool Dirty = true;
+      // Whether the last pass rebuilt Matrix
+      bool Changed = false;
+
+      // Transform Matrix was built from, relative to the parent for entities in a hierarchy
+      glm::vec3 Position{0.0f};
+      glm::vec3 Rotation{0.0f};
+      glm::vec3 Scale{1.0f};
+   };
+
+   // Parent and child links, managed by Scene::SetParent. An entity with a parent has its TransformComponent relative
+   // to the parent, WorldTransformComponent holds the composed matrix. Children form a list through their siblings.
+   struct HierarchyComponent
+   {
+      entt::entity Parent = entt::null;
+      entt::entity FirstChild = entt::null;
+      entt::entity PrevSibling = entt::null;
+      entt::entity NextSibling = entt::null;
+      uint32_t ChildCount = 0;
    };
 
    struct MeshRendererComponent
@@ -79,14 +118,17 @@ namespace SGE
 
       ScriptableEntity *(*InstantiateScript)() = nullptr;
       void (*DestroyScript)(NativeScriptComponent *) = nullptr;
+      ScriptAccess UpdateAccess = ScriptAccess::Scene;
 
       template <typename T>
       void Bind()
       {
+         UpdateAccess = T::UpdateAccess;
+         // Instances of a script type share a pool, see ScriptPool
          InstantiateScript = []()
-         { return static_cast<ScriptableEntity *>(new T()); };
+         { return static_cast<ScriptableEntity *>(ScriptPool<T>::Get().Create()); };
          DestroyScript = [](NativeScriptComponent *nsc)
-         {delete nsc->ScriptInstance; nsc->ScriptInstance = nullptr; };
+         {ScriptPool<T>::Get().Destroy(static_cast<T *>(nsc->ScriptInstance)); nsc->ScriptInstance = nullptr; };
       }
    };
 
@@ -107,28 +149,39 @@ namespace SGE
 
    struct RigidBodyComponent
    {
+      // Handle into the physics world's body store, holds its own state until registered
       flg::Body Body;
       bool UseGravity = true;
-      bool Registered = false;
 
       RigidBodyComponent() = default;
       RigidBodyComponent(const RigidBodyComponent &other) = default;
+      RigidBodyComponent(RigidBodyComponent &&other) = default;
+      RigidBodyComponent &operator=(const RigidBodyComponent &other) = default;
+      RigidBodyComponent &operator=(RigidBodyComponent &&other) = default;
 
       void AddForce(const glm::vec3 &force)
       {
-         Body.Force += force;
+         Body.AddForce(force);
       }
 
       void AddImpulse(const glm::vec3 &force)
       {
-         Body.Force = glm::vec3{0.0f};
-         Body.Velocity = glm::vec3{0.0f};
-         Body.Force += force;
+         Body.SetVelocity(glm::vec3{0.0f});
+         Body.SetForce(force);
+      }
+
+      // Only bodies whose category is in this body's mask (and the other way around) collide with it
+      void SetCollisionFilter(uint32_t category, uint32_t mask = flg::CollisionFilter::ALL)
+      {
+         Body.SetCollisionFilter({category, mask});
       }
    };
 
    struct SphereColliderComponent
    {
+      // Registered bodies point at the collider, so removing another one must not move it
+      static constexpr auto in_place_delete = true;
+
       flg::SphereCollider sphereCollider;
 
       SphereColliderComponent() = default;
@@ -137,6 +190,9 @@ namespace SGE
 
    struct PlaneColliderComponent
    {
+      // Kept in place like SphereColliderComponent
+      static constexpr auto in_place_delete = true;
+
       flg::PlaneCollider planeCollider;
 
       PlaneColliderComponent() = default;
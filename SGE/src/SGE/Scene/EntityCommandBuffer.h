@@ -0,0 +1,234 @@
+#ifndef ENTITYCOMMANDBUFFER_H
+#define ENTITYCOMMANDBUFFER_H
+
+#pragma once
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Core/Core.h"
+#include "Scene/Components.h"
+#include "Scene/Entity.h"
+
+namespace SGE
+{
+  // Entity a command buffer creates when it is played back, only meaningful to the buffer that handed it out
+  struct PendingEntity
+  {
+    uint32_t Index = static_cast<uint32_t>(-1);
+  };
+
+  // Structural changes recorded while the registry must not change (during the parallel script update, inside physics
+  // callbacks, mid iteration) and applied by the scene at its sync points. Scenes keep one buffer per job thread.
+  // Playback goes kind by kind: creates, component adds (replacing components the entity already has), component
+  // removes, deferred calls, destroys. So a destroyed entity is still there for the calls recorded with it.
+  class EntityCommandBuffer
+  {
+  public:
+    EntityCommandBuffer() = default;
+    EntityCommandBuffer(EntityCommandBuffer &&other) = default;
+    EntityCommandBuffer &operator=(EntityCommandBuffer &&other) = default;
+
+    // Tagged and placed like Scene::CreateEntity
+    PendingEntity CreateEntity(const std::string &name = "UNNAMED_ENTITY", const glm::vec3 &position = glm::vec3(0.0f))
+    {
+      m_Creates.push_back({m_Order, name, position});
+      return {static_cast<uint32_t>(m_Creates.size() - 1)};
+    }
+
+    void DestroyEntity(Entity entity) { m_Destroys.push_back(ToHandle(entity)); }
+
+    template <typename T, typename... Args>
+    void AddComponent(Entity entity, Args &&...args)
+    {
+      GetStream<T>().Adds.push_back({{ToHandle(entity), PendingEntity{}}, MakeComponent<T>(std::forward<Args>(args)...)});
+    }
+
+    template <typename T, typename... Args>
+    void AddComponent(PendingEntity entity, Args &&...args)
+    {
+      GetStream<T>().Adds.push_back({{entt::null, entity}, MakeComponent<T>(std::forward<Args>(args)...)});
+    }
+
+    // Script is instantiated by the scene's next update like any other unstarted script
+    template <typename T, typename EntityType>
+    void AddNativeScriptComponent(EntityType entity)
+    {
+      NativeScriptComponent nsc;
+      nsc.Bind<T>();
+      AddComponent<NativeScriptComponent>(entity, nsc);
+    }
+
+    template <typename T>
+    void RemoveComponent(Entity entity)
+    {
+      GetStream<T>().Removes.push_back({ToHandle(entity), PendingEntity{}});
+    }
+
+    template <typename T>
+    void RemoveComponent(PendingEntity entity)
+    {
+      GetStream<T>().Removes.push_back({entt::null, entity});
+    }
+
+    // Anything else that has to wait for the main thread, e.g. physics body writes
+    void Call(std::function<void()> fn) { m_Calls.push_back({m_Order, std::move(fn)}); }
+
+    bool Empty() const
+    {
+      for (const auto &stream : m_Streams)
+      {
+        if (!stream.second->Empty())
+          return false;
+      }
+      return m_Creates.empty() && m_Calls.empty() && m_Destroys.empty();
+    }
+
+    // Keeps the streams and their capacity for the next frame
+    void Clear()
+    {
+      m_Creates.clear();
+      m_Created.clear();
+      for (auto &stream : m_Streams)
+        stream.second->Clear();
+      m_Calls.clear();
+      m_Destroys.clear();
+    }
+
+  private:
+    struct Target
+    {
+      entt::entity Entity;
+      PendingEntity Pending;
+    };
+
+    struct CreateCommand
+    {
+      uint32_t Order;
+      std::string Name;
+      glm::vec3 Position;
+    };
+
+    struct CallCommand
+    {
+      uint32_t Order;
+      std::function<void()> Fn;
+    };
+
+    // Adds and removes of one component type, applied with the storage reserved once for the whole batch
+    class ComponentStream
+    {
+    public:
+      virtual ~ComponentStream() = default;
+
+      virtual void ApplyAdds(entt::registry &registry, const std::vector<entt::entity> &created) = 0;
+      virtual void ApplyRemoves(entt::registry &registry, const std::vector<entt::entity> &created) = 0;
+      virtual bool Empty() const = 0;
+      virtual void Clear() = 0;
+    };
+
+    template <typename T>
+    class TypedStream : public ComponentStream
+    {
+    public:
+      std::vector<std::pair<Target, T>> Adds;
+      std::vector<Target> Removes;
+
+      void ApplyAdds(entt::registry &registry, const std::vector<entt::entity> &created) override
+      {
+        if (Adds.empty())
+          return;
+
+        auto &storage = registry.storage<T>();
+        storage.reserve(storage.size() + Adds.size());
+        for (auto &[target, component] : Adds)
+        {
+          entt::entity entity = Resolve(target, created);
+          if (!registry.valid(entity))
+            continue;
+
+          // on_update only fires once the old script is overwritten, removing it first lets on_destroy return it to its pool
+          if constexpr (std::is_same_v<T, NativeScriptComponent>)
+            registry.remove<T>(entity);
+          registry.emplace_or_replace<T>(entity, std::move(component));
+        }
+      }
+
+      void ApplyRemoves(entt::registry &registry, const std::vector<entt::entity> &created) override
+      {
+        if (Removes.empty())
+          return;
+
+        m_Entities.clear();
+        for (const Target &target : Removes)
+        {
+          entt::entity entity = Resolve(target, created);
+          if (registry.valid(entity))
+            m_Entities.push_back(entity);
+        }
+        registry.remove<T>(m_Entities.begin(), m_Entities.end());
+      }
+
+      bool Empty() const override { return Adds.empty() && Removes.empty(); }
+
+      void Clear() override
+      {
+        Adds.clear();
+        Removes.clear();
+      }
+
+    private:
+      std::vector<entt::entity> m_Entities;
+    };
+
+    static entt::entity ToHandle(Entity entity) { return static_cast<entt::entity>(entity.Id()); }
+    static entt::entity Resolve(const Target &target, const std::vector<entt::entity> &created)
+    {
+      return target.Entity != entt::null ? target.Entity : created[target.Pending.Index];
+    }
+
+    // Same construction registry.emplace would use, aggregates like TransformComponent are brace initialized
+    template <typename T, typename... Args>
+    static T MakeComponent(Args &&...args)
+    {
+      if constexpr (std::is_aggregate_v<T>)
+        return T{std::forward<Args>(args)...};
+      else
+        return T(std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    TypedStream<T> &GetStream()
+    {
+      // Few component types per buffer, a linear search keeps them in first use order
+      const entt::id_type id = entt::type_hash<T>::value();
+      for (auto &[streamId, stream] : m_Streams)
+      {
+        if (streamId == id)
+          return static_cast<TypedStream<T> &>(*stream);
+      }
+
+      m_Streams.emplace_back(id, CreateScope<TypedStream<T>>());
+      return static_cast<TypedStream<T> &>(*m_Streams.back().second);
+    }
+
+  private:
+    // Position of the script recording, so creates and calls play back in script order whatever thread recorded them
+    uint32_t m_Order = 0;
+
+    std::vector<CreateCommand> m_Creates;
+    std::vector<entt::entity> m_Created; // Filled in at playback, indexed by PendingEntity
+    std::vector<std::pair<entt::id_type, Scope<ComponentStream>>> m_Streams;
+    std::vector<CallCommand> m_Calls;
+    std::vector<entt::entity> m_Destroys;
+
+    friend class Scene;
+  };
+} // namespace SGE
+
+#endif
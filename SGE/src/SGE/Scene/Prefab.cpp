@@ -0,0 +1,36 @@
+#include "Prefab.h"
+#include "Scene.h"
+#include "Renderer/ResourceManager.h"
+
+namespace SGE
+{
+	template <typename T>
+	static void CopyComponent(Entity entity, Prefab &prefab)
+	{
+		if (entity.HasComponent<T>())
+			prefab.AddComponent<T>(entity.GetComponent<T>());
+	}
+
+	Ref<Prefab> Prefab::CreatePrefab(const std::string &name)
+	{
+		return ResourceManager::CreatePrefab(name);
+	}
+
+	Prefab Prefab::FromEntity(Entity entity)
+	{
+		std::string name = entity.HasComponent<TagComponent>() ? entity.GetComponent<TagComponent>().Tag : "UNNAMED_ENTITY";
+		Prefab prefab(name, entity.GetComponent<TransformComponent>());
+
+		CopyComponent<MeshRendererComponent>(entity, prefab);
+		CopyComponent<SkinnedMeshRendererComponent>(entity, prefab);
+		CopyComponent<PointLightComponent>(entity, prefab);
+		CopyComponent<DirectionalLightComponent>(entity, prefab);
+		CopyComponent<Camera3DComponent>(entity, prefab);
+		CopyComponent<RigidBodyComponent>(entity, prefab);
+		CopyComponent<SphereColliderComponent>(entity, prefab);
+		CopyComponent<PlaneColliderComponent>(entity, prefab);
+		CopyComponent<NativeScriptComponent>(entity, prefab);
+
+		return prefab;
+	}
+}
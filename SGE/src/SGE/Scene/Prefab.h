@@ -0,0 +1,162 @@
+#ifndef PREFAB_H
+#define PREFAB_H
+
+#pragma once
+#include <entt/entt.hpp>
+
+#include <cassert>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Core/Core.h"
+#include "Scene/Components.h"
+#include "Scene/Entity.h"
+
+namespace SGE
+{
+  // Component values to stamp out many entities from, see Scene::Instantiate. Every instance gets the prefab's tag,
+  // a transform (the prefab's unless Instantiate is given one per instance) and a world transform, plus a copy of each
+  // component added here. Rigid bodies register with the physics world and scripts are instantiated by the scene's
+  // next update, like they are for any entity made while the scene plays.
+  class Prefab
+  {
+  public:
+    Prefab(const std::string &name = "UNNAMED_ENTITY", const TransformComponent &transform = TransformComponent())
+        : m_Name(name), m_Transform(transform) {}
+
+    Prefab(Prefab &&other) = default;
+    Prefab &operator=(Prefab &&other) = default;
+
+    // Registered with the ResourceManager under name, so any scene can instantiate it
+    static Ref<Prefab> CreatePrefab(const std::string &name);
+
+    // Snapshot of everything Scene::CreateEntity(Entity) clones: the renderers, lights, camera, rigid body (its state,
+    // not its registration), colliders and script binding. Hierarchy links are left out, instances are roots.
+    static Prefab FromEntity(Entity entity);
+
+    // Replaces the template of T if there is one already
+    template <typename T, typename... Args>
+    T &AddComponent(Args &&...args)
+    {
+      static_assert(!std::is_same_v<T, TagComponent> && !std::is_same_v<T, TransformComponent> && !std::is_same_v<T, WorldTransformComponent>,
+                    "Every instance gets these, see GetName and GetTransform");
+
+      T component = MakeComponent<T>(std::forward<Args>(args)...);
+      // Instances get scripts and colliders of their own
+      if constexpr (std::is_same_v<T, NativeScriptComponent>)
+        component.ScriptInstance = nullptr;
+      if constexpr (std::is_same_v<T, RigidBodyComponent>)
+        component.Body.SetCollider(nullptr);
+
+      if (TypedTemplate<T> *found = FindTemplate<T>())
+      {
+        found->Value = std::move(component);
+        return found->Value;
+      }
+
+      m_Templates.emplace_back(entt::type_hash<T>::value(), CreateScope<TypedTemplate<T>>(std::move(component)));
+      return static_cast<TypedTemplate<T> &>(*m_Templates.back().second).Value;
+    }
+
+    // Script is instantiated per instance by the scene's next update
+    template <typename T>
+    void AddNativeScriptComponent()
+    {
+      NativeScriptComponent nsc;
+      nsc.Bind<T>();
+      AddComponent<NativeScriptComponent>(nsc);
+    }
+
+    template <typename T>
+    bool HasComponent() const { return FindTemplate<T>() != nullptr; }
+
+    template <typename T>
+    T &GetComponent()
+    {
+      TypedTemplate<T> *found = FindTemplate<T>();
+      assert(found && "Prefab does not have the component");
+      return found->Value;
+    }
+
+    template <typename T>
+    void RemoveComponent()
+    {
+      const entt::id_type id = entt::type_hash<T>::value();
+      for (auto it = m_Templates.begin(); it != m_Templates.end(); it++)
+      {
+        if (it->first == id)
+        {
+          m_Templates.erase(it);
+          return;
+        }
+      }
+    }
+
+    const std::string &GetName() const { return m_Name; }
+    void SetName(const std::string &name) { m_Name = name; }
+
+    TransformComponent &GetTransform() { return m_Transform; }
+    const TransformComponent &GetTransform() const { return m_Transform; }
+
+  private:
+    // Copies of one component, inserted for a whole batch of instances with the storage reserved once
+    class ComponentTemplate
+    {
+    public:
+      virtual ~ComponentTemplate() = default;
+
+      virtual void Insert(entt::registry &registry, const std::vector<entt::entity> &entities) const = 0;
+    };
+
+    template <typename T>
+    class TypedTemplate : public ComponentTemplate
+    {
+    public:
+      TypedTemplate(T &&value)
+          : Value(std::move(value)) {}
+
+      T Value;
+
+      void Insert(entt::registry &registry, const std::vector<entt::entity> &entities) const override
+      {
+        auto &storage = registry.storage<T>();
+        storage.reserve(storage.size() + entities.size());
+        registry.insert<T>(entities.begin(), entities.end(), Value);
+      }
+    };
+
+    // Same construction registry.emplace would use, aggregates like TransformComponent are brace initialized
+    template <typename T, typename... Args>
+    static T MakeComponent(Args &&...args)
+    {
+      if constexpr (std::is_aggregate_v<T>)
+        return T{std::forward<Args>(args)...};
+      else
+        return T(std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    TypedTemplate<T> *FindTemplate() const
+    {
+      // A handful of component types per prefab, a linear search keeps them in the order they were added
+      const entt::id_type id = entt::type_hash<T>::value();
+      for (const auto &[templateId, component] : m_Templates)
+      {
+        if (templateId == id)
+          return static_cast<TypedTemplate<T> *>(component.get());
+      }
+      return nullptr;
+    }
+
+  private:
+    std::string m_Name;
+    TransformComponent m_Transform;
+    std::vector<std::pair<entt::id_type, Scope<ComponentTemplate>>> m_Templates;
+
+    friend class Scene;
+  };
+} // namespace SGE
+
+#endif
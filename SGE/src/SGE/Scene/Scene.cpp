@@ -3,19 +3,52 @@
 #include "SkinnedMeshRenderer/SkinnedMeshRenderer.h"
 #include "Systems.h"
 
+#include "Core/JobSystem.h"
 #include "Core/TimeStep.h"
+#include <cassert>
 #include <functional>
 
 namespace SGE
 {
+	// Scripts per job, most updates are short
+	static constexpr uint32_t SCRIPT_RANGE = 16;
+	// Transforms per job, a matrix rebuild is a few dozen flops
+	static constexpr uint32_t TRANSFORM_RANGE = 256;
+
 	Scene::Scene(const std::string &sceneName)
 		: m_Name(sceneName)
 	{
+		// Step physics on the engine's job threads (or threads of its own without a running Application),
+		// callbacks still fire on this thread. Scenes simulated side by side can lower it before playing.
+		if (JobSystem::IsRunning())
+			m_PhysicsWorld.SetTaskExecutor(JobSystem::GetTaskExecutor());
+		else
+			m_PhysicsWorld.SetThreadCount(0);
+
+		m_Commands.resize(JobSystem::GetThreadCount());
+		m_PlaybackCommands.resize(JobSystem::GetThreadCount());
+
+		// Bind Collision Callbacks
+		m_PhysicsWorld.SetOnCollisionEnterCallBack(std::bind(&Scene::CollisionEnterCallback, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+		m_PhysicsWorld.SetOnCollisionStayCallBack(std::bind(&Scene::CollisionStayCallback, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+		m_PhysicsWorld.SetOnCollisionExitCallBack(std::bind(&Scene::CollisionExitCallback, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+
+		// Scripts go back to their pools however their component is removed
+		m_Registry.on_destroy<NativeScriptComponent>().connect<&Scene::OnScriptDestroyed>(this);
 	}
 
 	Scene::~Scene()
 	{
-		flg::PhysicsWorld::Clear();
+		m_PhysicsWorld.Clear();
+
+		// Hand the scripts still alive back to their pools, the registry's own teardown does not emit on_destroy
+		auto view = m_Registry.view<NativeScriptComponent>();
+		for (auto entity : view)
+		{
+			auto &nsc = view.get<NativeScriptComponent>(entity);
+			if (nsc.ScriptInstance)
+				nsc.DestroyScript(&nsc);
+		}
 	}
 
 	void Scene::OnScenePlay()
@@ -28,9 +61,6 @@ namespace SGE
 			RegisterToPhysicsWorld(entity);
 		}
 
-		// Bind OnCollisionEnterCallback
-		flg::PhysicsWorld::SetOnCollisionEnterCallBack(std::bind(&Scene::CollisionEnterCallback, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
-
 		// Implement script OnStart methods
 		{
 			auto view = m_Registry.view<NativeScriptComponent>();
@@ -56,7 +86,7 @@ namespace SGE
 	void Scene::OnSceneStop()
 	{
 		// Clear Physics World
-		flg::PhysicsWorld::Clear();
+		m_PhysicsWorld.Clear();
 
 		// Change scene state
 		m_SceneState = SCENE_STATE::PAUSE;
@@ -70,6 +100,8 @@ namespace SGE
 			{
 				auto view = m_Registry.view<NativeScriptComponent>();
 
+				// Scripts that only touch their own entity are left for the parallel update below
+				m_ParallelScripts.clear();
 				for (auto entity : view)
 				{
 					auto &nsc = view.get<NativeScriptComponent>(entity);
@@ -83,16 +115,35 @@ namespace SGE
 						nsc.ScriptInstance->OnStart();
 					}
 
-					if (nsc.ScriptInstance)
-					{
+					if (!nsc.ScriptInstance)
+						continue;
+
+					if (nsc.UpdateAccess == ScriptAccess::OwnEntity)
+						m_ParallelScripts.push_back(nsc.ScriptInstance);
+					else
 						nsc.ScriptInstance->OnUpdate(timestep);
-					}
 				}
+
+				// No entities are created or removed until every range is done, commands wait for the sync point
+				JobSystem::ParallelFor(static_cast<uint32_t>(m_ParallelScripts.size()), SCRIPT_RANGE, [this, timestep](uint32_t begin, uint32_t end, uint32_t worker)
+									   {
+					EntityCommandBuffer &commands = m_Commands[worker];
+					for (uint32_t i = begin; i < end; i++)
+					{
+						commands.m_Order = i + 1;
+						m_ParallelScripts[i]->OnUpdate(timestep);
+					}
+					commands.m_Order = 0; });
+
+				PlaybackCommands();
 			}
 
 			// Update Physics
 			{
-				flg::PhysicsWorld::Step(timestep);
+				// Fixed rate steps, transforms are interpolated between the last two steps for rendering
+				m_PhysicsWorld.Advance(timestep);
+				const float alpha = m_PhysicsWorld.GetInterpolationAlpha();
+
 				auto group = m_Registry.group<RigidBodyComponent>(entt::get<TransformComponent>);
 				for (auto entity : group)
 				{
@@ -100,14 +151,17 @@ namespace SGE
 					auto &rb = group.get<RigidBodyComponent>(entity);
 
 					// Register all post play created entities
-					if (!rb.Registered)
+					if (!rb.Body.IsRegistered())
 						RegisterToPhysicsWorld({entity, this});
 
-					transform.Position = rb.Body.GetPosition();
+					transform.Position = rb.Body.GetInterpolatedPosition(alpha);
 				}
 			}
 		}
 
+		// Rebuild the world matrices of whatever moved, scripts, physics or the editor
+		UpdateWorldTransforms();
+
 		{
 			// Update Camera View Matrices
 			auto group = m_Registry.group<Camera3DComponent>(entt::get<TransformComponent>);
@@ -124,49 +178,361 @@ namespace SGE
 
 		{
 			// Draw Meshes
-			auto group = m_Registry.group<MeshRendererComponent, TransformComponent>();
+			auto group = m_Registry.group<MeshRendererComponent>(entt::get<WorldTransformComponent>);
 
 			for (auto entity : group)
 			{
 				auto &model = group.get<MeshRendererComponent>(entity);
-				auto &transform = group.get<TransformComponent>(entity);
-				Renderer::Draw(model.Model, transform.Position, transform.Rotation, transform.Scale);
+				auto &transform = group.get<WorldTransformComponent>(entity);
+				Renderer::Draw(model.Model, transform.Matrix);
 			}
 		}
 
 		// Draw Animated Meshes
 		{
-			auto group = m_Registry.group<SkinnedMeshRendererComponent>(entt::get<TransformComponent>);
+			auto group = m_Registry.group<SkinnedMeshRendererComponent>(entt::get<WorldTransformComponent>);
 
 			for (auto entity : group)
 			{
 				auto &model = group.get<SkinnedMeshRendererComponent>(entity);
-				auto &transform = group.get<TransformComponent>(entity);
-				SkinnedMeshRenderer::Draw(model.AnimatedModel, transform.Position, transform.Rotation, transform.Scale);
+				auto &transform = group.get<WorldTransformComponent>(entity);
+				SkinnedMeshRenderer::Draw(model.AnimatedModel, transform.Matrix);
 			}
 		}
 
-		// Clean Up
+		// Clean Up, commands from collision callbacks and scripts on the main thread
+		PlaybackCommands();
+	}
+
+	std::vector<Entity> Scene::Instantiate(const Prefab &prefab, uint32_t count, const std::vector<TransformComponent> &transforms)
+	{
+		assert((transforms.empty() || transforms.size() == count) && "One transform per instance, or none");
+
+		std::vector<entt::entity> entities(count);
+		m_Registry.create(entities.begin(), entities.end());
+
+		auto &tags = m_Registry.storage<TagComponent>();
+		tags.reserve(tags.size() + count);
+		m_Registry.insert<TagComponent>(entities.begin(), entities.end(), TagComponent(prefab.m_Name));
+
+		auto &transformStorage = m_Registry.storage<TransformComponent>();
+		transformStorage.reserve(transformStorage.size() + count);
+		if (transforms.empty())
+			m_Registry.insert<TransformComponent>(entities.begin(), entities.end(), prefab.m_Transform);
+		else
+			m_Registry.insert<TransformComponent>(entities.begin(), entities.end(), transforms.begin());
+
+		auto &worldTransforms = m_Registry.storage<WorldTransformComponent>();
+		worldTransforms.reserve(worldTransforms.size() + count);
+		m_Registry.insert<WorldTransformComponent>(entities.begin(), entities.end());
+
+		for (const auto &component : prefab.m_Templates)
+			component.second->Insert(m_Registry, entities);
+
+		std::vector<Entity> instances;
+		instances.reserve(count);
+		for (entt::entity entity : entities)
+			instances.push_back({entity, this});
+		return instances;
+	}
+
+	void Scene::PlaybackCommands()
+	{
+		m_Commands.swap(m_PlaybackCommands);
+
+		// Creates in script order so entity IDs do not depend on which thread updated which script, all in one batch
+		m_PendingCreates.clear();
+		for (EntityCommandBuffer &buffer : m_PlaybackCommands)
+		{
+			for (uint32_t i = 0; i < static_cast<uint32_t>(buffer.m_Creates.size()); i++)
+				m_PendingCreates.push_back({buffer.m_Creates[i].Order, &buffer, i});
+		}
+		std::stable_sort(m_PendingCreates.begin(), m_PendingCreates.end(), [](const PendingCreate &a, const PendingCreate &b)
+						 { return a.Order < b.Order; });
+
+		for (EntityCommandBuffer &buffer : m_PlaybackCommands)
+			buffer.m_Created.assign(buffer.m_Creates.size(), entt::null);
+
+		m_CreatedEntities.resize(m_PendingCreates.size());
+		m_Registry.create(m_CreatedEntities.begin(), m_CreatedEntities.end());
+		m_Registry.storage<TagComponent>().reserve(m_Registry.storage<TagComponent>().size() + m_CreatedEntities.size());
+		m_Registry.storage<TransformComponent>().reserve(m_Registry.storage<TransformComponent>().size() + m_CreatedEntities.size());
+		m_Registry.storage<WorldTransformComponent>().reserve(m_Registry.storage<WorldTransformComponent>().size() + m_CreatedEntities.size());
+		for (uint32_t i = 0; i < static_cast<uint32_t>(m_PendingCreates.size()); i++)
+		{
+			const PendingCreate &pending = m_PendingCreates[i];
+			const auto &create = pending.Buffer->m_Creates[pending.Index];
+			m_Registry.emplace<TagComponent>(m_CreatedEntities[i], create.Name);
+			m_Registry.emplace<TransformComponent>(m_CreatedEntities[i], create.Position);
+			m_Registry.emplace<WorldTransformComponent>(m_CreatedEntities[i]);
+			pending.Buffer->m_Created[pending.Index] = m_CreatedEntities[i];
+		}
+
+		// Component adds then removes, one batch per type and buffer
+		for (EntityCommandBuffer &buffer : m_PlaybackCommands)
+		{
+			for (auto &stream : buffer.m_Streams)
+				stream.second->ApplyAdds(m_Registry, buffer.m_Created);
+		}
+		for (EntityCommandBuffer &buffer : m_PlaybackCommands)
+		{
+			for (auto &stream : buffer.m_Streams)
+				stream.second->ApplyRemoves(m_Registry, buffer.m_Created);
+		}
+
+		// Calls in script order, calls recording commands of their own go to the next sync point
+		m_PendingCalls.clear();
+		for (EntityCommandBuffer &buffer : m_PlaybackCommands)
+		{
+			for (auto &call : buffer.m_Calls)
+				m_PendingCalls.push_back({call.Order, &call.Fn});
+		}
+		std::stable_sort(m_PendingCalls.begin(), m_PendingCalls.end(), [](const auto &a, const auto &b)
+						 { return a.first < b.first; });
+		for (auto &call : m_PendingCalls)
+			(*call.second)();
+
+		// Destroys last, an entity removed twice is only destroyed once
+		m_DestroyedEntities.clear();
+		for (EntityCommandBuffer &buffer : m_PlaybackCommands)
+			m_DestroyedEntities.insert(m_DestroyedEntities.end(), buffer.m_Destroys.begin(), buffer.m_Destroys.end());
+
+		// Children go with their parents, the loop reaches the children it appends too
+		for (size_t i = 0; i < m_DestroyedEntities.size(); i++)
+		{
+			const auto *links = m_Registry.valid(m_DestroyedEntities[i]) ? m_Registry.try_get<HierarchyComponent>(m_DestroyedEntities[i]) : nullptr;
+			if (!links)
+				continue;
+
+			for (entt::entity child = links->FirstChild; child != entt::null; child = m_Registry.get<HierarchyComponent>(child).NextSibling)
+				m_DestroyedEntities.push_back(child);
+		}
+		std::sort(m_DestroyedEntities.begin(), m_DestroyedEntities.end());
+		m_DestroyedEntities.erase(std::unique(m_DestroyedEntities.begin(), m_DestroyedEntities.end()), m_DestroyedEntities.end());
+		m_DestroyedEntities.erase(std::remove_if(m_DestroyedEntities.begin(), m_DestroyedEntities.end(), [this](entt::entity entity)
+												 { return !m_Registry.valid(entity); }),
+								  m_DestroyedEntities.end());
+
+		for (entt::entity entity : m_DestroyedEntities)
+			DetachEntity(entity);
+		m_Registry.destroy(m_DestroyedEntities.begin(), m_DestroyedEntities.end());
+
+		for (EntityCommandBuffer &buffer : m_PlaybackCommands)
+			buffer.Clear();
+	}
+
+	// Takes the transform's values when they differ from the ones world was built from or world is marked dirty
+	static bool TakeTransform(WorldTransformComponent &world, const TransformComponent &transform)
+	{
+		const bool changed = world.Dirty || transform.Position != world.Position || transform.Rotation != world.Rotation || transform.Scale != world.Scale;
+		world.Dirty = false;
+		if (changed)
 		{
-			for (Entity entity : m_EntitiesToDestroy)
+			world.Position = transform.Position;
+			world.Rotation = transform.Rotation;
+			world.Scale = transform.Scale;
+		}
+		return changed;
+	}
+
+	void Scene::UpdateWorldTransforms()
+	{
+		// Entities outside any hierarchy only touch their own two components, so they all go in one parallel batch
+		auto group = m_Registry.group<WorldTransformComponent>(entt::get<TransformComponent>, entt::exclude<HierarchyComponent>);
+		JobSystem::ParallelFor(static_cast<uint32_t>(group.size()), TRANSFORM_RANGE, [&group](uint32_t begin, uint32_t end, uint32_t)
+							   {
+			for (uint32_t i = begin; i < end; i++)
 			{
-				// Remove From Physics World
-				if (entity.HasComponent<RigidBodyComponent>())
+				const entt::entity entity = group[i];
+				auto &world = group.get<WorldTransformComponent>(entity);
+				world.Changed = TakeTransform(world, group.get<TransformComponent>(entity));
+				if (world.Changed)
+					world.Matrix = group.get<TransformComponent>(entity).GetMatrix();
+			} });
+
+		if (m_HierarchyChanged)
+			RebuildHierarchyOrder();
+
+		// Hierarchies level by level. A level only starts once every parent in the level above is done, and its nodes
+		// do not depend on each other, so separate roots and siblings update in parallel. Nodes whose transform and
+		// parent are unchanged keep their matrices, so untouched subtrees only cost the comparison.
+		auto &worlds = m_Registry.storage<WorldTransformComponent>();
+		auto &transforms = m_Registry.storage<TransformComponent>();
+		for (uint32_t level = 0; level + 1 < static_cast<uint32_t>(m_HierarchyLevels.size()); level++)
+		{
+			const uint32_t first = m_HierarchyLevels[level];
+			const uint32_t count = m_HierarchyLevels[level + 1] - first;
+			JobSystem::ParallelFor(count, TRANSFORM_RANGE, [this, &worlds, &transforms, first](uint32_t begin, uint32_t end, uint32_t)
+								   {
+				for (uint32_t i = first + begin; i < first + end; i++)
 				{
-					flg::PhysicsWorld::RemoveBody(&entity.GetComponent<RigidBodyComponent>().Body);
-				}
+					const HierarchyNode &node = m_HierarchyNodes[i];
+					auto &world = worlds.get(node.Entity);
+					const auto &transform = transforms.get(node.Entity);
+
+					const bool localChanged = TakeTransform(world, transform);
+					world.Changed = localChanged || (node.Parent != NO_PARENT && m_NodeChanged[node.Parent]);
+					m_NodeChanged[i] = world.Changed;
+					if (!world.Changed)
+						continue;
+
+					if (localChanged)
+						m_LocalMatrices[i] = transform.GetMatrix();
+					m_WorldMatrices[i] = node.Parent == NO_PARENT ? m_LocalMatrices[i] : m_WorldMatrices[node.Parent] * m_LocalMatrices[i];
+					world.Matrix = m_WorldMatrices[i];
+				} });
+		}
+	}
 
-				// Call On Destroy If Scriptable
-				if (entity.HasComponent<NativeScriptComponent>())
-				{
-					auto &nsc = entity.GetComponent<NativeScriptComponent>();
-					nsc.ScriptInstance->OnDestroy();
-					// entity.GetComponent<NativeScriptComponent>().DestroyScript(&nsc);
-				}
+	void Scene::RebuildHierarchyOrder()
+	{
+		auto view = m_Registry.view<HierarchyComponent>();
 
-				m_Registry.destroy(entity.m_EntityHandle);
+		m_HierarchyNodes.clear();
+		m_HierarchyLevels.clear();
+		for (auto entity : view)
+		{
+			if (view.get<HierarchyComponent>(entity).Parent == entt::null)
+				m_HierarchyNodes.push_back({entity, NO_PARENT});
+		}
+
+		// Every pass over a level appends the next one
+		uint32_t begin = 0;
+		while (begin < static_cast<uint32_t>(m_HierarchyNodes.size()))
+		{
+			const uint32_t end = static_cast<uint32_t>(m_HierarchyNodes.size());
+			m_HierarchyLevels.push_back(begin);
+			for (uint32_t i = begin; i < end; i++)
+			{
+				entt::entity child = view.get<HierarchyComponent>(m_HierarchyNodes[i].Entity).FirstChild;
+				for (; child != entt::null; child = view.get<HierarchyComponent>(child).NextSibling)
+					m_HierarchyNodes.push_back({child, i});
 			}
-			m_EntitiesToDestroy.clear();
+			begin = end;
+		}
+		m_HierarchyLevels.push_back(static_cast<uint32_t>(m_HierarchyNodes.size()));
+
+		// Matrices moved to new slots, every node is rebuilt once
+		m_LocalMatrices.resize(m_HierarchyNodes.size());
+		m_WorldMatrices.resize(m_HierarchyNodes.size());
+		m_NodeChanged.assign(m_HierarchyNodes.size(), 0);
+		for (const HierarchyNode &node : m_HierarchyNodes)
+			m_Registry.get<WorldTransformComponent>(node.Entity).Dirty = true;
+
+		m_HierarchyChanged = false;
+	}
+
+	void Scene::SetParent(Entity child, Entity parent)
+	{
+		const entt::entity childHandle = child.m_EntityHandle;
+		const entt::entity parentHandle = parent.m_EntityHandle;
+
+		// Parenting to an entity in child's own subtree would make a cycle
+		for (entt::entity ancestor = parentHandle; ancestor != entt::null;)
+		{
+			assert(ancestor != childHandle && "An entity cannot be parented to itself or its descendants");
+			const auto *links = m_Registry.try_get<HierarchyComponent>(ancestor);
+			ancestor = links ? links->Parent : entt::null;
+		}
+
+		const auto *links = m_Registry.try_get<HierarchyComponent>(childHandle);
+		if ((links ? links->Parent : entt::null) == parentHandle)
+			return;
+
+		Unlink(childHandle);
+		m_Registry.get<WorldTransformComponent>(childHandle).Dirty = true;
+		m_HierarchyChanged = true;
+
+		if (parentHandle == entt::null)
+		{
+			RemoveEmptyHierarchy(childHandle);
+			return;
+		}
+
+		// Both emplaced before taking references, an emplace can move the other's component
+		m_Registry.get_or_emplace<HierarchyComponent>(parentHandle);
+		m_Registry.get_or_emplace<HierarchyComponent>(childHandle);
+		auto &parentLinks = m_Registry.get<HierarchyComponent>(parentHandle);
+		auto &childLinks = m_Registry.get<HierarchyComponent>(childHandle);
+
+		childLinks.Parent = parentHandle;
+		childLinks.PrevSibling = entt::null;
+		childLinks.NextSibling = parentLinks.FirstChild;
+		if (parentLinks.FirstChild != entt::null)
+			m_Registry.get<HierarchyComponent>(parentLinks.FirstChild).PrevSibling = childHandle;
+		parentLinks.FirstChild = childHandle;
+		parentLinks.ChildCount++;
+	}
+
+	Entity Scene::GetParent(Entity entity)
+	{
+		const auto *links = m_Registry.try_get<HierarchyComponent>(entity.m_EntityHandle);
+		return {links ? links->Parent : entt::null, this};
+	}
+
+	// Takes the entity out of its parent's child list, keeping its own children
+	void Scene::Unlink(entt::entity entity)
+	{
+		auto *links = m_Registry.try_get<HierarchyComponent>(entity);
+		if (!links || links->Parent == entt::null)
+			return;
+
+		const entt::entity parent = links->Parent;
+		auto &parentLinks = m_Registry.get<HierarchyComponent>(parent);
+		if (links->PrevSibling != entt::null)
+			m_Registry.get<HierarchyComponent>(links->PrevSibling).NextSibling = links->NextSibling;
+		else
+			parentLinks.FirstChild = links->NextSibling;
+		if (links->NextSibling != entt::null)
+			m_Registry.get<HierarchyComponent>(links->NextSibling).PrevSibling = links->PrevSibling;
+		parentLinks.ChildCount--;
+
+		links->Parent = entt::null;
+		links->PrevSibling = entt::null;
+		links->NextSibling = entt::null;
+		m_HierarchyChanged = true;
+
+		RemoveEmptyHierarchy(parent);
+	}
+
+	// Entities without parent or children go back to the flat transform pass
+	void Scene::RemoveEmptyHierarchy(entt::entity entity)
+	{
+		const auto *links = m_Registry.try_get<HierarchyComponent>(entity);
+		if (links && links->Parent == entt::null && links->ChildCount == 0)
+			m_Registry.remove<HierarchyComponent>(entity);
+	}
+
+	// Takes the entity out of the physics world and lets its script clean up before the registry destroys it,
+	// the script's slot goes back to its pool
+	void Scene::DetachEntity(entt::entity e)
+	{
+		Entity entity{e, this};
+
+		// Leave the parent's child list, the hierarchy order is rebuilt without the entity
+		if (entity.HasComponent<HierarchyComponent>())
+		{
+			Unlink(e);
+			m_HierarchyChanged = true;
+		}
+
+		// Remove From Physics World
+		if (entity.HasComponent<RigidBodyComponent>())
+		{
+			m_PhysicsWorld.RemoveBody(&entity.GetComponent<RigidBodyComponent>().Body);
+		}
+
+		// Script goes first, so OnDestroy still sees the rest of the entity
+		m_Registry.remove<NativeScriptComponent>(e);
+	}
+
+	void Scene::OnScriptDestroyed(entt::registry &registry, entt::entity entity)
+	{
+		auto &nsc = registry.get<NativeScriptComponent>(entity);
+		if (nsc.ScriptInstance)
+		{
+			nsc.ScriptInstance->OnDestroy();
+			nsc.DestroyScript(&nsc);
 		}
 	}
 
@@ -178,9 +544,7 @@ namespace SGE
 
 		// Assign Owner Entity ID & Transform Position To Physics Body
 		rb.Body.SetEntityOwnerID(e.Id());
-		rb.Body.BodyTransform.Position = transform.Position;
-		rb.Body.BodyTransform.Rotation = transform.Rotation;
-		rb.Body.BodyTransform.Scale = transform.Scale;
+		rb.Body.SetPosition(transform.Position);
 
 		// Calculate Values for Colliders
 		if (e.HasComponent<PlaneColliderComponent>())
@@ -190,19 +554,18 @@ namespace SGE
 			// TODO: calculate normal for any orientation
 			collider.planeCollider.Normal = {0.0, 1.0f, 0.0};
 
-			rb.Body.BodyCollider = &collider.planeCollider;
+			rb.Body.SetCollider(&collider.planeCollider);
 		}
 
 		if (e.HasComponent<SphereColliderComponent>())
 		{
 			auto &collider = e.GetComponent<SphereColliderComponent>();
 
-			rb.Body.BodyCollider = &collider.sphereCollider;
+			rb.Body.SetCollider(&collider.sphereCollider);
 		}
 
-		// Register Rigid Body and Add to Physics System
-		rb.Registered = true;
-		flg::PhysicsWorld::AddBody(&rb.Body);
+		// Add to Physics System
+		m_PhysicsWorld.AddBody(&rb.Body);
 	}
 
 	void Scene::CollisionEnterCallback(flg::CollisionPoints &col, uint32_t entityA, uint32_t entityB)
@@ -222,7 +585,40 @@ namespace SGE
 				return;
 		}
 	};
-	void Scene::CollisionExitCallback(flg::CollisionPoints &col, uint32_t entityA, uint32_t entityB){
 
+	void Scene::CollisionStayCallback(flg::CollisionPoints &col, uint32_t entityA, uint32_t entityB)
+	{
+		Entity e1{entityA, this};
+		Entity e2{entityB, this};
+
+		if (e1.HasComponent<SGE::NativeScriptComponent>())
+		{
+			if (e1.GetComponent<SGE::NativeScriptComponent>().ScriptInstance->OnCollisionStay(col, e2))
+				return;
+		}
+
+		if (e2.HasComponent<SGE::NativeScriptComponent>())
+		{
+			if (e2.GetComponent<SGE::NativeScriptComponent>().ScriptInstance->OnCollisionStay(col, e1))
+				return;
+		}
+	};
+
+	void Scene::CollisionExitCallback(flg::CollisionPoints &col, uint32_t entityA, uint32_t entityB)
+	{
+		Entity e1{entityA, this};
+		Entity e2{entityB, this};
+
+		if (e1.HasComponent<SGE::NativeScriptComponent>())
+		{
+			if (e1.GetComponent<SGE::NativeScriptComponent>().ScriptInstance->OnCollisionExit(col, e2))
+				return;
+		}
+
+		if (e2.HasComponent<SGE::NativeScriptComponent>())
+		{
+			if (e2.GetComponent<SGE::NativeScriptComponent>().ScriptInstance->OnCollisionExit(col, e1))
+				return;
+		}
 	};
 }
\ No newline at end of file
@@ -6,6 +6,9 @@
 #include "Entity.h"
 #include "Components.h"
 #include "Renderer/Shader.h"
+#include "Core/JobSystem.h"
+#include "Scene/EntityCommandBuffer.h"
+#include "Scene/Prefab.h"
 
 #include <Physics.h>
 #include <glm/glm.hpp>
@@ -57,12 +60,14 @@ namespace SGE
             Entity entity = {m_Registry.create(), this};
             entity.AddComponent<TagComponent>(name);
             entity.AddComponent<TransformComponent>(position);
+            entity.AddComponent<WorldTransformComponent>();
             return entity;
         }
 
+        // Removed at the next sync point, see Commands
         void RemoveEntity(Entity entity)
         {
-            m_EntitiesToDestroy.push_back(entity);
+            Commands().DestroyEntity(entity);
 
             // auto &transform = entity.AddComponent<TransformComponent>();
             // transform = otherEntity.GetComponent<TransformComponent>();
@@ -77,47 +82,95 @@ namespace SGE
             //     entity.AddComponent<SkinnedMeshRendererComponent>(otherEntity.GetComponent<SkinnedMeshRendererComponent>().AnimatedModel);
         }
 
-        Entity CreateEntity(Entity otherEntity, const std::string &name = "UNNAMED_ENTITY")
+        // Copy of otherEntity's components, see Prefab::FromEntity. Its script gets an instance of its own.
+        // Keeps otherEntity's tag unless given a name.
+        Entity CreateEntity(Entity otherEntity, const std::string &name = "")
         {
-            Entity entity = {m_Registry.create(), this};
-
-            auto &transform = entity.AddComponent<TransformComponent>();
-            transform = otherEntity.GetComponent<TransformComponent>();
-
-            if (otherEntity.HasComponent<TagComponent>())
-                entity.AddComponent<TagComponent>(otherEntity.GetComponent<TagComponent>().Tag);
-
-            if (otherEntity.HasComponent<MeshRendererComponent>())
-                entity.AddComponent<MeshRendererComponent>(otherEntity.GetComponent<MeshRendererComponent>().Model);
+            Prefab prefab = Prefab::FromEntity(otherEntity);
+            if (!name.empty())
+                prefab.SetName(name);
+            return Instantiate(prefab).front();
+        }
 
-            if (otherEntity.HasComponent<SkinnedMeshRendererComponent>())
-                entity.AddComponent<SkinnedMeshRendererComponent>(otherEntity.GetComponent<SkinnedMeshRendererComponent>().AnimatedModel);
+        // Creates count entities from prefab in one batch, each component type inserted over the whole range with
+        // its storage reserved once. transforms is empty (every instance takes the prefab's) or holds one per instance.
+        // Changes the registry, so scripts on job threads go through Defer.
+        std::vector<Entity> Instantiate(const Prefab &prefab, uint32_t count = 1, const std::vector<TransformComponent> &transforms = {});
 
-            if (otherEntity.HasComponent<RigidBodyComponent>())
-                entity.AddComponent<SGE::RigidBodyComponent>();
+        // Makes child's transform relative to parent, keeping its local values. A null parent makes child a root again.
+        // Children are destroyed along with their parent. Changes the registry, so scripts on job threads go through Defer.
+        void SetParent(Entity child, Entity parent);
+        Entity GetParent(Entity entity);
 
-            if (otherEntity.HasComponent<SphereColliderComponent>())
-                entity.AddComponent<SphereColliderComponent>().sphereCollider.Radius = 1.0f;
+        // Command buffer of the calling job thread, played back after the script phase and again after the physics
+        // and draw phases. Scripts updated on the job threads go through it for anything outside their own entity.
+        EntityCommandBuffer &Commands() { return m_Commands[JobSystem::GetWorkerIndex()]; }
 
-            return entity;
-        }
+        // Runs fn on the main thread at the next sync point, in the order of the scripts that made the calls
+        void Defer(std::function<void()> fn) { Commands().Call(std::move(fn)); }
 
         void RegisterToPhysicsWorld(Entity e);
 
         void CollisionEnterCallback(flg::CollisionPoints &col, uint32_t entityA, uint32_t entityB);
+        void CollisionStayCallback(flg::CollisionPoints &col, uint32_t entityA, uint32_t entityB);
         void CollisionExitCallback(flg::CollisionPoints &col, uint32_t entityA, uint32_t entityB);
 
         entt::registry &Registry() { return m_Registry; }
+        flg::PhysicsWorld &GetPhysicsWorld() { return m_PhysicsWorld; }
 
         SCENE_STATE m_SceneState = SCENE_STATE::PAUSE;
 
         inline const std::string &GetSceneName() const { return m_Name; }
 
     private:
+        void PlaybackCommands();
+        void UpdateWorldTransforms();
+        void RebuildHierarchyOrder();
+        void Unlink(entt::entity entity);
+        void RemoveEmptyHierarchy(entt::entity entity);
+        void DetachEntity(entt::entity entity);
+        void OnScriptDestroyed(entt::registry &registry, entt::entity entity);
+
+    private:
+        // Declared before the registry so it outlives the bodies held by rigid body components
+        flg::PhysicsWorld m_PhysicsWorld;
         entt::registry m_Registry;
         std::string m_Name;
 
-        std::vector<Entity> m_EntitiesToDestroy;
+        // Scripts
+        std::vector<ScriptableEntity *> m_ParallelScripts;
+
+        // Structural changes, one buffer per job thread. Swapped with the playback set at a sync point so commands
+        // recorded by deferred calls wait for the next one.
+        std::vector<EntityCommandBuffer> m_Commands;
+        std::vector<EntityCommandBuffer> m_PlaybackCommands;
+
+        // Playback scratch
+        struct PendingCreate
+        {
+            uint32_t Order;
+            EntityCommandBuffer *Buffer;
+            uint32_t Index;
+        };
+        std::vector<PendingCreate> m_PendingCreates;
+        std::vector<entt::entity> m_CreatedEntities;
+        std::vector<std::pair<uint32_t, std::function<void()> *>> m_PendingCalls;
+        std::vector<entt::entity> m_DestroyedEntities;
+
+        // Entities in a hierarchy in breadth first order, each level after the one holding its parents. Rebuilt when
+        // links change, the matrices are kept between frames in the same order so unchanged parents need no lookup.
+        static constexpr uint32_t NO_PARENT = static_cast<uint32_t>(-1);
+        struct HierarchyNode
+        {
+            entt::entity Entity;
+            uint32_t Parent; // Index into m_HierarchyNodes
+        };
+        std::vector<HierarchyNode> m_HierarchyNodes;
+        std::vector<uint32_t> m_HierarchyLevels; // First node of every level, then the node count
+        std::vector<glm::mat4> m_LocalMatrices;
+        std::vector<glm::mat4> m_WorldMatrices;
+        std::vector<uint8_t> m_NodeChanged;
+        bool m_HierarchyChanged = false;
 
         friend class Entity;
         friend class SceneSerializer;
@@ -174,6 +174,14 @@ void SceneSerializer::Deserialize(const std::string &filePath) {
       if (rbComponent) {
         auto &rb = deserializedEntity.AddComponent<RigidBodyComponent>();
         rb.UseGravity = rbComponent["UseGravity"].as<bool>();
+
+        // Scenes saved without a filter keep colliding with everything
+        flg::CollisionFilter filter;
+        if (rbComponent["CollisionCategory"])
+          filter.Category = rbComponent["CollisionCategory"].as<uint32_t>();
+        if (rbComponent["CollisionMask"])
+          filter.Mask = rbComponent["CollisionMask"].as<uint32_t>();
+        rb.Body.SetCollisionFilter(filter);
       }
 
       auto sphereColliderComponent = entity["SphereColliderComponent"];
@@ -311,6 +319,10 @@ void SceneSerializer::SerializeEntity(YAML::Emitter &out, Entity entity) {
     auto &rbComponent = entity.GetComponent<RigidBodyComponent>();
     out << YAML::Key << "UseGravity" << YAML::Value << rbComponent.UseGravity;
 
+    flg::CollisionFilter filter = rbComponent.Body.GetCollisionFilter();
+    out << YAML::Key << "CollisionCategory" << YAML::Value << filter.Category;
+    out << YAML::Key << "CollisionMask" << YAML::Value << filter.Mask;
+
     out << YAML::EndMap;
   }
 
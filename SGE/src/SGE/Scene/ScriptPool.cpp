@@ -0,0 +1,11 @@
+#include "ScriptPool.h"
+
+namespace SGE
+{
+	// Made on first use, so it is there for pools created during static initialization and outlives them
+	std::vector<const ScriptPoolStats *> &ScriptPools::Pools()
+	{
+		static std::vector<const ScriptPoolStats *> pools;
+		return pools;
+	}
+}
@@ -0,0 +1,110 @@
+#ifndef SCRIPTPOOL_H
+#define SCRIPTPOOL_H
+
+#pragma once
+#include <entt/entt.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <string_view>
+#include <vector>
+
+#include "Core/Core.h"
+
+namespace SGE
+{
+  // Instance counts of one script type's pool
+  struct ScriptPoolStats
+  {
+    std::string_view Name;
+    uint32_t Live = 0;
+    uint32_t Peak = 0;
+    uint32_t Capacity = 0;
+  };
+
+  // Every script pool made so far, in the order their types were first bound
+  class ScriptPools
+  {
+  public:
+    static const std::vector<const ScriptPoolStats *> &GetStats() { return Pools(); }
+
+  private:
+    static std::vector<const ScriptPoolStats *> &Pools();
+
+    template <typename T>
+    friend class ScriptPool;
+  };
+
+  // Storage for the instances of one script type, used by NativeScriptComponent::Bind<T>.
+  // Slots come in fixed size blocks so instances of a type sit next to each other, and a destroyed script's slot goes
+  // to the next instance instead of back to the heap. Scripts are only created and destroyed on the main thread.
+  template <typename T>
+  class ScriptPool
+  {
+  public:
+    static ScriptPool &Get()
+    {
+      static ScriptPool pool;
+      return pool;
+    }
+
+    T *Create()
+    {
+      if (m_FreeSlots.empty())
+        Grow();
+
+      Slot *slot = m_FreeSlots.back();
+      m_FreeSlots.pop_back();
+
+      m_Stats.Live++;
+      m_Stats.Peak = std::max(m_Stats.Peak, m_Stats.Live);
+      return new (slot) T();
+    }
+
+    void Destroy(T *script)
+    {
+      script->~T();
+      m_FreeSlots.push_back(reinterpret_cast<Slot *>(script));
+      m_Stats.Live--;
+    }
+
+    const ScriptPoolStats &GetStats() const { return m_Stats; }
+
+  private:
+    static constexpr uint32_t BLOCK_SIZE = 64;
+
+    struct alignas(T) Slot
+    {
+      unsigned char Bytes[sizeof(T)];
+    };
+
+    ScriptPool()
+    {
+      m_Stats.Name = entt::type_name<T>::value();
+      ScriptPools::Pools().push_back(&m_Stats);
+    }
+
+    ScriptPool(const ScriptPool &) = delete;
+    ScriptPool &operator=(const ScriptPool &) = delete;
+
+    void Grow()
+    {
+      m_Blocks.push_back(CreateScope<Slot[]>(BLOCK_SIZE));
+      m_Stats.Capacity += BLOCK_SIZE;
+
+      // Sized for every slot so Destroy never reallocates, pushed back to front so the block fills in order
+      m_FreeSlots.reserve(m_Stats.Capacity);
+      Slot *block = m_Blocks.back().get();
+      for (uint32_t i = BLOCK_SIZE; i > 0; i--)
+        m_FreeSlots.push_back(block + i - 1);
+    }
+
+  private:
+    std::vector<Scope<Slot[]>> m_Blocks;
+    std::vector<Slot *> m_FreeSlots; // Most recently freed last, its memory is the likeliest to still be cached
+    ScriptPoolStats m_Stats;
+  };
+} // namespace SGE
+
+#endif
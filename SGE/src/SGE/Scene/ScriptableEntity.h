@@ -8,10 +8,21 @@
 
 namespace SGE
 {
+  // What a script's OnUpdate reads and writes, which decides the thread it runs on
+  enum class ScriptAccess
+  {
+    Scene,    // Anything in the scene, updated one after the other on the main thread
+    OwnEntity // Only its own entity's components, updated across the job threads
+  };
+
   class ScriptableEntity
   {
   public:
-    virtual ~ScriptableEntity() { std::cout << "nice" << std::endl; };
+    // Scripts redeclare this as OwnEntity to opt in to the parallel update. Such an OnUpdate must leave other entities,
+    // physics bodies (setters wake bodies in the shared store), input and entity creation or removal to Scene::Defer.
+    static constexpr ScriptAccess UpdateAccess = ScriptAccess::Scene;
+
+    virtual ~ScriptableEntity() = default;
 
     template <typename T>
     T &GetComponent() { return m_Entity.GetComponent<T>(); }
@@ -33,12 +44,27 @@ namespace SGE
     virtual void OnDestroy(){};
     virtual void OnUpdate(TimeStep timestep){};
 
+    // Fired once when the bodies start touching
     virtual bool OnCollisionEnter(flg::CollisionPoints &colPoints,
                                   Entity colEntity)
     {
       return false;
     };
 
+    // Fired every physics step after Enter while the bodies keep touching
+    virtual bool OnCollisionStay(flg::CollisionPoints &colPoints,
+                                 Entity colEntity)
+    {
+      return false;
+    };
+
+    // Fired once when the bodies stop touching
+    virtual bool OnCollisionExit(flg::CollisionPoints &colPoints,
+                                 Entity colEntity)
+    {
+      return false;
+    };
+
     Entity GameObject() { return m_Entity; };
     Scene *Scene() { return m_Entity.GetSceneHandle(); };
 